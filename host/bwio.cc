@@ -0,0 +1,30 @@
+/*
+ * bwio.cc - busy-wait UART access for bwio on the host
+ *
+ * COM2 is the terminal; output to COM1 is dropped.
+ */
+
+#include "lib/bwio.h"
+
+#include <unistd.h>
+
+int bwsetfifo(unsigned int channel, int state) { return 0; }
+
+int bwsetspeed(unsigned int channel, int speed) { return 0; }
+
+int bwsetstp2(unsigned int channel, int select) { return 0; }
+
+int bwputc(unsigned int channel, char c) {
+  if (channel == COM2) {
+    write(STDOUT_FILENO, &c, 1);
+  }
+  return 0;
+}
+
+int bwgetc(unsigned int channel) {
+  unsigned char c = 0;
+  if (channel == COM2) {
+    read(STDIN_FILENO, &c, 1);
+  }
+  return c;
+}
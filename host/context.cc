@@ -0,0 +1,350 @@
+/*
+ * context.cc - context switch, traps and interrupts of the host build
+ *
+ * The kernel runs on the stack of each core's thread (see cores.cc) and every
+ * task on its own stack from the stack pool. userMode() switches to the
+ * current task; a system call or an interrupt switches back, and userMode()
+ * then calls trap() and enterKernel() the way exception.S does on the board.
+ * A task may be switched back in on another core than the one it left.
+ *
+ * Interrupts are polled from a periodic SIGALRM, which only core 0 takes. If
+ * the signal arrives while a task runs, the handler makes the task call
+ * hostIrqEntry as if it had been interrupted, and the task traps to the kernel
+ * for userMode() to take the interrupt; if it arrives in the kernel the
+ * interrupt waits until the next userMode(). The preempt signal of the other
+ * cores stops their task the same way.
+ */
+
+#include <signal.h>
+#include <stdint.h>
+#include <sys/time.h>
+#include <ucontext.h>
+
+#include "host.h"
+#include "kern/arch/ts7200.h"
+#include "kern/syscall.h"
+#include "kern/task.h"
+#include "kern/tick_page.h"
+
+// how often the timer signal looks for pending interrupts
+#define HOST_IRQ_POLL_US 200
+
+// trap code of a task stopped by the timer signal; userMode() takes the
+// interrupt under the kernel lock
+#define HOST_IRQ_TRAP 0xffffffffu
+
+#define HOST_SIGNAL_STACK_SIZE 0x10000
+
+extern "C" {
+void trap(Trapframe *tf);
+void hostSwitch(void **save, void *load);
+void hostIrqEntry();
+}
+
+// save the callee-saved registers on the current stack, store its sp in *save
+// and resume the context whose sp is load
+asm(R"(
+  .text
+  .globl hostSwitch
+  .type hostSwitch, @function
+hostSwitch:
+  pushq %rbp
+  pushq %rbx
+  pushq %r12
+  pushq %r13
+  pushq %r14
+  pushq %r15
+  movq %rsp, (%rdi)
+  movq %rsi, %rsp
+  popq %r15
+  popq %r14
+  popq %r13
+  popq %r12
+  popq %rbx
+  popq %rbp
+  ret
+)");
+
+// entered from the signal handler with the interrupted pc pushed below the
+// red zone; saves what a call would clobber and calls hostIrqTrap(pc)
+asm(R"(
+  .text
+  .globl hostIrqEntry
+  .type hostIrqEntry, @function
+hostIrqEntry:
+  pushfq
+  cld
+  pushq %rax
+  pushq %rcx
+  pushq %rdx
+  pushq %rsi
+  pushq %rdi
+  pushq %r8
+  pushq %r9
+  pushq %r10
+  pushq %r11
+  pushq %rbp
+  movq %rsp, %rbp
+  subq $512, %rsp
+  andq $-64, %rsp
+  fxsave64 (%rsp)
+  movq 88(%rbp), %rdi
+  call hostIrqTrap
+  fxrstor64 (%rsp)
+  movq %rbp, %rsp
+  popq %rbp
+  popq %r11
+  popq %r10
+  popq %r9
+  popq %r8
+  popq %rdi
+  popq %rsi
+  popq %rdx
+  popq %rcx
+  popq %rax
+  popfq
+  ret $128
+)");
+
+namespace {
+
+struct Core {
+  void *kernelSp;
+  // filled on the task stack before switching back to the kernel
+  Trapframe trapTf;
+  unsigned int trapCode;
+  // set while the kernel or a trap runs; the timer signal then leaves the
+  // interrupt pending instead of entering the kernel
+  volatile sig_atomic_t inKernel = 1;
+  // set by the preempt signal of a core other than 0 when it stops the task
+  volatile sig_atomic_t preempt = 0;
+};
+
+CORE_LOCAL Core core;
+
+void *taskSp[NUM_TASKS];
+// tid whose context taskSp holds, so that a new task in the slot is noticed
+int taskSpTid[NUM_TASKS];
+
+// set by the timer signal when some interrupt source may be pending
+volatile sig_atomic_t irqRaised = 0;
+// timer signals since the other cores were last preempted
+int pollsSinceTick = 0;
+
+char signalStack[HOST_SIGNAL_STACK_SIZE];
+
+// code on a task stack may continue on another core after a switch, so it
+// looks up the core and its task through these rather than letting the
+// compiler keep the address of the thread's copy across the switch
+__attribute__((noipa)) Core &taskCore() { return core; }
+
+__attribute__((noipa)) TaskDescriptor *taskCurrent() { return curTask; }
+
+// inKernel is volatile, but the trapframe and trapCode are not; the barriers
+// keep the compiler from moving their accesses to where an interrupt may come
+inline void maskIrq() {
+  taskCore().inKernel = 1;
+  asm volatile("" : : : "memory");
+}
+
+inline void unmaskIrq() {
+  asm volatile("" : : : "memory");
+  taskCore().inKernel = 0;
+}
+
+bool irqPending() {
+  return host::timerDue(TIMER1_BASE) || host::timerDue(TIMER3_BASE) ||
+         host::uartPending(COM1) || host::uartPending(COM2);
+}
+
+/**
+ * @brief take one pending interrupt, in the order getIrqStatus() reports them
+ * on the board
+ *
+ * @return the interrupt code, -1 if none is pending
+ */
+int takeIrq() {
+  if (!irqRaised) {
+    return -1;
+  }
+  irqRaised = 0;
+  int code = -1;
+  if (host::timerExpire(TIMER1_BASE)) {
+    code = IRQ_TC1UI;
+  } else if (host::uartPending(COM2)) {
+    code = IRQ_UART2;
+  } else if (host::uartPending(COM1)) {
+    code = IRQ_UART1;
+  } else if (host::timerExpire(TIMER3_BASE)) {
+    code = IRQ_TC3UI;
+  }
+  if (code != -1) {
+    // others may still be pending
+    irqRaised = 1;
+  }
+  return code;
+}
+
+// make the interrupted task call hostIrqEntry when the handler returns
+void stopTask(void *context) {
+  greg_t *regs = ((ucontext_t *)context)->uc_mcontext.gregs;
+  uintptr_t *sp = (uintptr_t *)(regs[REG_RSP] - 128);  // skip the red zone
+  *--sp = regs[REG_RIP];
+  regs[REG_RSP] = (greg_t)sp;
+  regs[REG_RIP] = (greg_t)hostIrqEntry;
+}
+
+void onTimerSignal(int, siginfo_t *, void *context) {
+  // the other cores take no interrupts, so every tick they are made to trap
+  // as the timer interrupt makes core 0, for time slices and budgets
+  if (++pollsSinceTick == TICK_MS * 1000 / HOST_IRQ_POLL_US) {
+    pollsSinceTick = 0;
+    host::coresPreempt();
+  }
+  host::uartPoll();
+  if (!irqPending()) {
+    return;
+  }
+  irqRaised = 1;
+  if (core.inKernel) {
+    return;
+  }
+  core.inKernel = 1;
+  stopTask(context);
+}
+
+void onPreemptSignal(int, siginfo_t *, void *context) {
+  if (core.inKernel) {
+    return;
+  }
+  core.inKernel = 1;
+  core.preempt = 1;
+  stopTask(context);
+}
+
+void taskEntry() {
+  // taskStart(fn) or taskStartArgs(fn, args); read before interrupts are let
+  // in, since an interrupt stores the interrupted pc in tf.lrSVC
+  Trapframe &tf = taskCurrent()->tf;
+  void (*entry)(uintptr_t, uintptr_t) =
+      (void (*)(uintptr_t, uintptr_t))(uintptr_t)tf.lrSVC;
+  uintptr_t r0 = tf.r0, r1 = tf.r1;
+  unmaskIrq();
+  entry(r0, r1);
+}
+
+// lay out a stack that hostSwitch() resumes into taskEntry()
+void *newContext(addr_t top) {
+  uintptr_t *sp = (uintptr_t *)(uintptr_t)(top & ~15);
+  *--sp = 0;  // taskEntry's return address, never used
+  *--sp = (uintptr_t)taskEntry;
+  for (int i = 0; i < 6; ++i) {
+    *--sp = 0;  // callee-saved registers
+  }
+  return sp;
+}
+
+// runs on the task stack with inKernel set and trapTf filled
+void enterTrap(unsigned int code) {
+  Core &c = taskCore();
+  c.trapCode = code;
+  hostSwitch(&taskSp[taskCurrent()->tid & TASK_INDEX_MASK], c.kernelSp);
+  unmaskIrq();
+}
+
+}  // namespace
+
+extern "C" void hostIrqTrap(uintptr_t pc) {
+  Core &c = taskCore();
+  if (!irqRaised && !c.preempt) {
+    unmaskIrq();
+    return;
+  }
+  c.trapTf = taskCurrent()->tf;
+  c.trapTf.lrSVC = pc;
+  enterTrap(HOST_IRQ_TRAP);
+}
+
+/**
+ * @brief system call from a task; the 5th argument is passed on the task
+ * stack as on the board
+ *
+ * @return r0 of the task after the kernel handled the call
+ */
+extern "C" long hostSyscall(unsigned int code, long a0, long a1, long a2,
+                            long a3, long a4, void *pc) {
+  maskIrq();
+  int arg4 = a4;
+  Trapframe &trapTf = taskCore().trapTf;
+  trapTf = taskCurrent()->tf;
+  trapTf.r0 = a0;
+  trapTf.r1 = a1;
+  trapTf.r2 = a2;
+  trapTf.r3 = a3;
+  trapTf.r13 = (uintptr_t)&arg4;
+  trapTf.lrSVC = (uintptr_t)pc;
+  enterTrap(code);
+  return (int)taskCurrent()->tf.r0;
+}
+
+extern "C" void userMode(Trapframe *tf) {
+  int index = curTask->tid & TASK_INDEX_MASK;
+  if (taskSpTid[index] != curTask->tid) {
+    taskSpTid[index] = curTask->tid;
+    taskSp[index] = newContext(tf->r13);
+  }
+  // an interrupt that arrived in the kernel is taken before the task runs; if
+  // the one that stopped the task has been taken already, the task goes on
+  // unless its core was preempted
+  int code = takeIrq();
+  while (code == -1) {
+    host::kernelUnlock();
+    hostSwitch(&core.kernelSp, taskSp[index]);
+    host::kernelLock();
+    tf = &core.trapTf;
+    if (core.trapCode != HOST_IRQ_TRAP) {
+      code = core.trapCode;
+    } else if ((code = takeIrq()) == -1 && core.preempt) {
+      // the task yields as it would to a timer interrupt
+      code = SYS_YIELD;
+    }
+    core.preempt = 0;
+  }
+  trap(tf);
+  enterKernel(code);
+}
+
+namespace host {
+
+void irqBootstrap() {
+  for (int i = 0; i < NUM_TASKS; ++i) {
+    taskSpTid[i] = -1;
+  }
+  core.inKernel = 1;
+  irqRaised = 0;
+
+  stack_t ss{};
+  ss.ss_sp = signalStack;
+  ss.ss_size = sizeof(signalStack);
+  sigaltstack(&ss, nullptr);
+
+  struct sigaction sa {};
+  sa.sa_sigaction = onTimerSignal;
+  sa.sa_flags = SA_SIGINFO | SA_ONSTACK | SA_RESTART;
+  sigemptyset(&sa.sa_mask);
+  sigaction(SIGALRM, &sa, nullptr);
+  sa.sa_sigaction = onPreemptSignal;
+  sigaction(HOST_PREEMPT_SIGNAL, &sa, nullptr);
+
+  itimerval it{};
+  it.it_interval.tv_usec = HOST_IRQ_POLL_US;
+  it.it_value.tv_usec = HOST_IRQ_POLL_US;
+  setitimer(ITIMER_REAL, &it, nullptr);
+}
+
+void irqExit() {
+  itimerval it{};
+  setitimer(ITIMER_REAL, &it, nullptr);
+}
+
+}  // namespace host
@@ -0,0 +1,174 @@
+/*
+ * cores.cc - several cores in one host kernel
+ *
+ * Each core is a thread. A core holds the kernel lock from the moment it
+ * enters the kernel until it switches to a task, so the kernel code is never
+ * run by two cores at once and keeps no locks of its own; tasks run unlocked,
+ * in parallel. Core 0 is the thread that booted the kernel. The others are
+ * started with signals blocked, so that core 0 takes every interrupt, and run
+ * the scheduling loop of kmain() from then on.
+ *
+ * readyQueues has one PriorityQueues per core. A task readied by a core goes
+ * on that core's queue, except at the lowest level, which only core 0 runs:
+ * the idle task there spins without system calls, and the idle time is
+ * measured with TIMER2 on core 0. A core schedules the first task it finds
+ * going down the levels, looking at its own queue and then stealing from the
+ * other cores at each level. One that finds nothing waits for a task to be
+ * readied; when every core would wait, no task is ready at all, and core 0
+ * returns null as the single-core kernel does.
+ *
+ * The other cores take no interrupts. Instead, core 0 sends them
+ * HOST_PREEMPT_SIGNAL every tick, which makes their running task yield as the
+ * timer interrupt makes the task of core 0, so that time slices and budgets
+ * apply on every core. Message passing between tasks on different cores goes
+ * through the kernel lock like everything else.
+ */
+
+#include <pthread.h>
+#include <signal.h>
+
+#define HOST_CORE_SIGNAL_STACK_SIZE 0x4000
+
+#include "host.h"
+#include "kern/task.h"
+
+CORE_LOCAL int coreId;
+
+namespace {
+
+// set by -threads before the kernel boots
+int cores = 1;
+
+pthread_mutex_t kernelMutex = PTHREAD_MUTEX_INITIALIZER;
+// signalled when a task is readied while some core waits
+pthread_cond_t readied = PTHREAD_COND_INITIALIZER;
+// cores waiting in ReadyQueues::dequeue()
+int waiting = 0;
+
+pthread_t threads[NUM_CORES];
+// set once the threads exist, read by the timer signal
+volatile sig_atomic_t started = 0;
+char signalStacks[NUM_CORES][HOST_CORE_SIGNAL_STACK_SIZE];
+
+void *coreMain(void *id) {
+  coreId = (int)(long)id;
+  // the preempt signal is handled on its own stack, not the task's
+  stack_t ss{};
+  ss.ss_sp = signalStacks[coreId];
+  ss.ss_size = sizeof(signalStacks[coreId]);
+  sigaltstack(&ss, nullptr);
+  sigset_t preempt;
+  sigemptyset(&preempt);
+  sigaddset(&preempt, HOST_PREEMPT_SIGNAL);
+  pthread_sigmask(SIG_UNBLOCK, &preempt, nullptr);
+
+  pthread_mutex_lock(&kernelMutex);
+  // taskSchedule() only returns null on core 0
+  while (true) {
+    taskActivate(taskSchedule());
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+namespace host {
+
+void setCores(int n) {
+  if (n < 1) {
+    n = 1;
+  } else if (n > NUM_CORES) {
+    n = NUM_CORES;
+  }
+  cores = n;
+}
+
+void coresBootstrap() {
+  coreId = 0;
+  waiting = 0;
+  if (cores == 1) {
+    return;
+  }
+  pthread_mutex_lock(&kernelMutex);
+  // the other cores inherit the mask, so that core 0 gets every signal
+  sigset_t all, old;
+  sigfillset(&all);
+  pthread_sigmask(SIG_BLOCK, &all, &old);
+  for (long i = 1; i < cores; ++i) {
+    pthread_create(&threads[i], nullptr, coreMain, (void *)i);
+    pthread_detach(threads[i]);
+  }
+  pthread_sigmask(SIG_SETMASK, &old, nullptr);
+  started = 1;
+}
+
+void coresPreempt() {
+  if (!started) {
+    return;
+  }
+  for (int i = 1; i < cores; ++i) {
+    pthread_kill(threads[i], HOST_PREEMPT_SIGNAL);
+  }
+}
+
+void kernelLock() {
+  if (cores > 1) {
+    pthread_mutex_lock(&kernelMutex);
+  }
+}
+
+void kernelUnlock() {
+  if (cores > 1) {
+    pthread_mutex_unlock(&kernelMutex);
+  }
+}
+
+}  // namespace host
+
+void ReadyQueues::enqueue(TaskDescriptor *task) {
+  bool lowest = task->priority == NUM_PRIORITY_LEVELS - 1;
+  task->core = lowest ? 0 : coreId;
+  queues[task->core].enqueue(task);
+  if (waiting == 0) {
+    return;
+  }
+  if (lowest) {
+    // only core 0 may take it, and it need not be the one signalled
+    pthread_cond_broadcast(&readied);
+  } else {
+    pthread_cond_signal(&readied);
+  }
+}
+
+TaskDescriptor *ReadyQueues::dequeue() {
+  while (true) {
+    for (int i = 0; i < NUM_PRIORITY_LEVELS; ++i) {
+      TaskDescriptor *task = queues[coreId].dequeue(i);
+      // the lowest level stays on core 0
+      for (int c = 0; !task && c < cores && i < NUM_PRIORITY_LEVELS - 1; ++c) {
+        task = queues[c].dequeue(i);
+      }
+      if (task) {
+        return task;
+      }
+    }
+    if (waiting == cores - 1) {
+      // every other core waits too, so nothing will be readied
+      if (coreId == 0) {
+        return nullptr;
+      }
+      pthread_cond_broadcast(&readied);
+    }
+    ++waiting;
+    pthread_cond_wait(&readied, &kernelMutex);
+    --waiting;
+  }
+}
+
+bool ReadyQueues::remove(TaskDescriptor *task) {
+  return queues[task->core].remove(task);
+}
+
+bool ReadyQueues::isEmpty(int priority) {
+  return queues[coreId].isEmpty(priority);
+}
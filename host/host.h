@@ -0,0 +1,71 @@
+#ifndef HOST_HOST_H_
+#define HOST_HOST_H_
+
+#include <signal.h>
+
+// sent to the cores other than 0 every tick, see cores.cc
+#define HOST_PREEMPT_SIGNAL SIGUSR1
+
+// Glue between the simulated devices and the trap code of the host build.
+// Functions marked signal-safe are also called from the timer signal handler.
+namespace host {
+
+// nanoseconds since sysBootstrap(); signal-safe
+long long nowNs();
+
+// whether the timer has passed an expiry not yet taken; signal-safe
+bool timerDue(unsigned int timerBase);
+
+// take one expiry of the timer if it is due
+bool timerExpire(unsigned int timerBase);
+
+// look for input on the host side of the UARTs; signal-safe
+void uartPoll();
+
+// whether the UART has something for its interrupt handler; signal-safe
+bool uartPending(unsigned int channel);
+
+// connect COM1 to the socket fd instead of the simulated train controller;
+// called before the kernel boots
+void uartLink(int fd);
+
+// set up the timer signal that drives the interrupts
+void irqBootstrap();
+
+void irqExit();
+
+// run the kernel on n cores, at most NUM_CORES; called before it boots
+void setCores(int n);
+
+// start the cores other than core 0, which takes the kernel lock
+void coresBootstrap();
+
+// taken by a core while it runs the kernel, see cores.cc; nothing on one core
+void kernelLock();
+
+void kernelUnlock();
+
+// stop the task running on each core other than 0 and make it yield;
+// signal-safe
+void coresPreempt();
+
+// run instances kernels side by side, each in its own process and started by
+// run(index); their output is printed after all have finished, or dropped
+// unless keepOutput
+// @return 0 if every instance exited cleanly
+int runInstances(int instances, int (*run)(int instance), bool keepOutput);
+
+// time run(cores) for 1, 2, 4, 8 and 16 cores, each in its own process, and
+// print one line per count:
+// scale <cores> <wall ms> <speedup over one core, x100>
+// The tests run should be CPU-bound and spread over many tasks.
+int scalingBenchmark(int (*run)(int cores));
+
+// run two kernels whose COM1s are joined by a socket pair; run(0) and run(1)
+// start them. Output is printed as for runInstances().
+// @return 0 if both exited cleanly
+int runLinked(int (*run)(int instance));
+
+}  // namespace host
+
+#endif  // HOST_HOST_H_
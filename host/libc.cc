@@ -0,0 +1,55 @@
+/*
+ * libc.cc - memory functions for the host build
+ *
+ * The compiler calls these for struct copies and clears. They replace the C
+ * library's, which may use AVX registers that the interrupt entry does not
+ * save; built without loop distribution so they do not call themselves.
+ */
+
+#include <stddef.h>
+
+extern "C" {
+
+void *memcpy(void *dst, const void *src, size_t n) {
+  char *d = (char *)dst;
+  const char *s = (const char *)src;
+  for (size_t i = 0; i < n; ++i) {
+    d[i] = s[i];
+  }
+  return dst;
+}
+
+void *memmove(void *dst, const void *src, size_t n) {
+  char *d = (char *)dst;
+  const char *s = (const char *)src;
+  if (d < s) {
+    for (size_t i = 0; i < n; ++i) {
+      d[i] = s[i];
+    }
+  } else {
+    for (size_t i = n; i > 0; --i) {
+      d[i - 1] = s[i - 1];
+    }
+  }
+  return dst;
+}
+
+void *memset(void *dst, int c, size_t n) {
+  char *d = (char *)dst;
+  for (size_t i = 0; i < n; ++i) {
+    d[i] = c;
+  }
+  return dst;
+}
+
+int memcmp(const void *a, const void *b, size_t n) {
+  const unsigned char *p = (const unsigned char *)a;
+  const unsigned char *q = (const unsigned char *)b;
+  for (size_t i = 0; i < n; ++i) {
+    if (p[i] != q[i]) {
+      return p[i] - q[i];
+    }
+  }
+  return 0;
+}
+}
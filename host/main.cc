@@ -0,0 +1,129 @@
+/*
+ * main.cc - entry point of the host build
+ *
+ * Without arguments the first task is boot() and the kernel runs the whole
+ * system with the terminal as COM2. Otherwise each argument names a perf_test
+ * to run in turn, after which the kernel shuts down:
+ *
+ *   host/kmain yield churn create sleep sleepers latency edf periodic timers
+ *              setpriority routing routingpar
+ *
+ * In front of the test names, -threads <n> runs the kernel on n cores, 1 by
+ * default (see cores.cc), and -scale times the tests on 1 to 16 cores. -j <n>
+ * runs n kernels at once, each in its own process (see parallel.cc). Each
+ * instance gets its index as perf_test::instance and the seed plus its index
+ * as perf_test::seed; -seed <n> in front of everything sets the seed, 1 by
+ * default. -scale without test names scales routingpar, which spreads the
+ * routing test over 16 tasks:
+ *
+ *   host/kmain -threads 4 routingpar
+ *   host/kmain -j 8 latency
+ *   host/kmain -seed 7 -j 4 routing
+ *   host/kmain -scale
+ *
+ * -link runs two kernels with their COM1s joined, the first running testA and
+ * the second testB, e.g. remote SRR against an echo server on the peer:
+ *
+ *   host/kmain -link remote remoteecho
+ */
+
+#include "host.h"
+#include "lib/string.h"
+#include "perf_test.h"
+
+// kern/kmain.cc is built with main renamed to kmain and boot to hostBoot
+int kmain();
+void boot();
+
+namespace {
+
+int hostArgc;
+char **hostArgv;
+
+// seed of instance 0, set by -seed
+unsigned int baseSeed = 1;
+
+// the test -scale runs when given none
+char routingName[] = "routingpar";
+char *scaleArgv[] = {nullptr, routingName};
+
+// test names of the two kernels of -link
+char *linkTests[2];
+
+// the number in s, 0 if s is not a number
+int parseCount(const char *s) {
+  int n = 0;
+  for (; *s >= '0' && *s <= '9'; ++s) {
+    n = n * 10 + *s - '0';
+  }
+  return *s ? 0 : n;
+}
+
+int runTests(int instance) {
+  perf_test::instance = instance;
+  perf_test::seed = baseSeed + instance;
+  return kmain();
+}
+
+int runCores(int cores) {
+  host::setCores(cores);
+  return runTests(0);
+}
+
+int runLinkedTest(int instance) {
+  hostArgc = 2;
+  hostArgv[1] = linkTests[instance];
+  return kmain();
+}
+
+}  // namespace
+
+void hostBoot() {
+  if (hostArgc <= 1) {
+    boot();
+    return;
+  }
+  perf_test::runNamed(hostArgc - 1, hostArgv + 1);
+}
+
+int main(int argc, char **argv) {
+  if (argc > 2 && String{argv[1]} == String{"-seed"}) {
+    baseSeed = parseCount(argv[2]);
+    argc -= 2;
+    argv += 2;
+    argv[0] = argv[-2];
+  }
+  if (argc > 2 && String{argv[1]} == String{"-threads"}) {
+    host::setCores(parseCount(argv[2]));
+    argc -= 2;
+    argv += 2;
+    argv[0] = argv[-2];
+  }
+  hostArgc = argc;
+  hostArgv = argv;
+  if (argc > 3 && String{argv[1]} == String{"-j"}) {
+    int instances = parseCount(argv[2]);
+    // the test names take the place of the option
+    hostArgc = argc - 2;
+    hostArgv = argv + 2;
+    hostArgv[0] = argv[0];
+    return host::runInstances(instances, runTests, true);
+  }
+  if (argc > 1 && String{argv[1]} == String{"-scale"}) {
+    hostArgc = argc - 1;
+    hostArgv = argv + 1;
+    hostArgv[0] = argv[0];
+    if (hostArgc == 1) {
+      scaleArgv[0] = argv[0];
+      hostArgc = 2;
+      hostArgv = scaleArgv;
+    }
+    return host::scalingBenchmark(runCores);
+  }
+  if (argc == 4 && String{argv[1]} == String{"-link"}) {
+    linkTests[0] = argv[2];
+    linkTests[1] = argv[3];
+    return host::runLinked(runLinkedTest);
+  }
+  return runTests(0);
+}
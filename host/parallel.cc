@@ -0,0 +1,151 @@
+/*
+ * parallel.cc - several host kernels at once
+ *
+ * runInstances() runs whole kernels side by side, one process each, for runs
+ * that need not share anything, such as seeded sweeps. Every instance keeps
+ * the exact SRR semantics of the board. run(index) is told its instance
+ * index, so each kernel can draw different inputs.
+ *
+ * scalingBenchmark() instead times one kernel on a growing number of cores
+ * (see cores.cc). Scaling only means something for CPU-bound tests spread
+ * over many tasks, such as routingpar; tests that sleep on the clock server
+ * take the same wall time at any count.
+ *
+ * runLinked() joins two instances by their COM1s for remote sends (see
+ * user/include/remote.h).
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "host.h"
+
+#define HOST_MAX_INSTANCES 64
+
+namespace {
+
+long long wallNs() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * @brief start run(instance) in a child process with stdin closed and its
+ * output sent to out, or dropped if out is null; COM1 is connected to linkFd
+ * unless it is -1
+ *
+ * @return pid of the child, -1 on failure
+ */
+int spawn(int (*run)(int), int instance, FILE *out, int linkFd) {
+  fflush(stdout);
+  int pid = fork();
+  if (pid != 0) {
+    return pid;
+  }
+  int null = open("/dev/null", O_RDWR);
+  dup2(null, STDIN_FILENO);
+  dup2(out ? fileno(out) : null, STDOUT_FILENO);
+  if (linkFd != -1) {
+    host::uartLink(linkFd);
+  }
+  _exit(run(instance));
+}
+
+/**
+ * @brief wait for the children, then print the output of each in one piece,
+ * in order
+ *
+ * @return 0 if every child exited cleanly
+ */
+int collect(int instances, const int *pids, FILE *const *outs) {
+  int failed = 0;
+  for (int i = 0; i < instances; ++i) {
+    int status = 1;
+    if (pids[i] == -1 || waitpid(pids[i], &status, 0) != pids[i] ||
+        !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      ++failed;
+    }
+  }
+
+  // output of each instance in one piece, in order
+  for (int i = 0; i < instances; ++i) {
+    if (!outs[i]) {
+      continue;
+    }
+    if (instances > 1) {
+      printf("--- instance %d\n", i);
+    }
+    rewind(outs[i]);
+    char buf[4096];
+    size_t len;
+    while ((len = fread(buf, 1, sizeof(buf), outs[i])) > 0) {
+      fwrite(buf, 1, len, stdout);
+    }
+    fclose(outs[i]);
+  }
+  fflush(stdout);
+  return failed ? 1 : 0;
+}
+
+}  // namespace
+
+namespace host {
+
+int runInstances(int instances, int (*run)(int), bool keepOutput) {
+  if (instances < 1 || instances > HOST_MAX_INSTANCES) {
+    fprintf(stderr, "instances must be between 1 and %d\n", HOST_MAX_INSTANCES);
+    return 1;
+  }
+  int pids[HOST_MAX_INSTANCES];
+  FILE *outs[HOST_MAX_INSTANCES];
+  for (int i = 0; i < instances; ++i) {
+    outs[i] = keepOutput ? tmpfile() : nullptr;
+    pids[i] = spawn(run, i, outs[i], -1);
+  }
+  return collect(instances, pids, outs);
+}
+
+int runLinked(int (*run)(int)) {
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+    perror("socketpair");
+    return 1;
+  }
+  int pids[2];
+  FILE *outs[2];
+  for (int i = 0; i < 2; ++i) {
+    outs[i] = tmpfile();
+    pids[i] = spawn(run, i, outs[i], fds[i]);
+    close(fds[i]);
+  }
+  return collect(2, pids, outs);
+}
+
+int scalingBenchmark(int (*run)(int)) {
+  long long base = 0;
+  for (int cores = 1; cores <= 16; cores *= 2) {
+    long long start = wallNs();
+    int pid = spawn(run, cores, nullptr, -1);
+    FILE *out = nullptr;
+    if (collect(1, &pid, &out) != 0) {
+      fprintf(stderr, "scale %d: the kernel failed\n", cores);
+      return 1;
+    }
+    long long elapsed = wallNs() - start;
+    if (cores == 1) {
+      base = elapsed;
+    }
+    // speedup over one core, x100
+    printf("scale %d %lld %lld\n", cores, elapsed / 1000000,
+           base * 100 / elapsed);
+    fflush(stdout);
+  }
+  return 0;
+}
+
+}  // namespace host
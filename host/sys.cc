@@ -0,0 +1,86 @@
+/*
+ * sys.cc - boot and exit of the host build
+ *
+ * The stack region, the tick page and the TS-7200 device window are mapped at
+ * their board addresses, so the kernel and the tasks use them unchanged.
+ * Device registers become plain memory that the simulated devices read where
+ * needed, and the idle task's read of HALT returns at once.
+ */
+
+#include "kern/sys.h"
+
+#include <signal.h>
+#include <sys/mman.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "host.h"
+#include "kern/arch/ts7200.h"
+#include "kern/stack.h"
+#include "kern/tick_page.h"
+
+#define PAGE_SIZE 0x1000
+#define DEVICE_BASE 0x80000000
+#define DEVICE_SIZE 0x1000000
+
+unsigned int idleTime;
+
+namespace {
+
+bool rawTerminal = false;
+termios savedTerminal;
+
+void mapFixed(addr_t start, addr_t end) {
+  void *addr = (void *)(unsigned long)start;
+  if (mmap(addr, end - start, PROT_READ | PROT_WRITE,
+           MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1,
+           0) != addr) {
+    const char msg[] = "[kernel] FATAL: cannot map board memory\n";
+    write(STDERR_FILENO, msg, sizeof(msg) - 1);
+    _exit(1);
+  }
+}
+
+void restoreTerminal() {
+  if (rawTerminal) {
+    tcsetattr(STDIN_FILENO, TCSANOW, &savedTerminal);
+    rawTerminal = false;
+  }
+}
+
+void onTerminate(int) {
+  restoreTerminal();
+  _exit(1);
+}
+
+}  // namespace
+
+KERN_INIT void sysBootstrap(addr_t lr) {
+  (void)lr;
+  idleTime = 0;
+  host::nowNs();
+
+  mapFixed(USER_STACK_START - USER_STACK_REGION, TICK_PAGE_ADDR + PAGE_SIZE);
+  mapFixed(DEVICE_BASE, DEVICE_BASE + DEVICE_SIZE);
+
+  // the console reads keys one by one and echoes them itself
+  if (isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &savedTerminal) == 0) {
+    termios raw = savedTerminal;
+    raw.c_iflag &= ~(ICRNL | IXON);
+    raw.c_lflag &= ~(ICANON | ECHO);
+    raw.c_cc[VMIN] = 1;
+    raw.c_cc[VTIME] = 0;
+    rawTerminal = tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0;
+  }
+  signal(SIGINT, onTerminate);
+  signal(SIGTERM, onTerminate);
+
+  host::irqBootstrap();
+  host::coresBootstrap();
+}
+
+KERN_INIT void kExit() {
+  host::irqExit();
+  restoreTerminal();
+  _exit(0);
+}
@@ -0,0 +1,22 @@
+/*
+ * syscall_user.cc - system call stubs of the host build
+ *
+ * Generated from the list in kern/syscall/syscall_user.S. Every stub takes
+ * the largest number of arguments a call has and hands them to the kernel
+ * with its return address.
+ */
+
+#include "kern/syscall_code.h"
+
+extern "C" long hostSyscall(unsigned int code, long a0, long a1, long a2,
+                            long a3, long a4, void *pc);
+
+#undef SYSCALL_FUNC
+#define SYSCALL_FUNC(name, code)                                            \
+  extern "C" __attribute__((noinline)) long name(long a0, long a1, long a2, \
+                                                 long a3, long a4) {        \
+    return hostSyscall(code, a0, a1, a2, a3, a4,                            \
+                       __builtin_return_address(0));                        \
+  }
+
+#include "../kern/syscall/syscall_user.S"
@@ -0,0 +1,124 @@
+/*
+ * timer.cc - TS-7200 timers simulated from the host monotonic clock
+ *
+ * A running timer counts down from its load value at TIMER3_FRQ and reloads
+ * on expiry, or in free-running mode expires once and wraps past 0. The load
+ * value is still written to the mapped LDR register, so code that sets LDR
+ * directly before timer::start() works unchanged.
+ */
+
+#include <stdint.h>
+#include <time.h>
+
+#include "host.h"
+#include "lib/timer.h"
+
+namespace {
+
+struct SimTimer {
+  bool running;
+  bool periodic;
+  unsigned int load;
+  long long start;        // nowNs() when started
+  unsigned int stopped;   // counter value when stopped
+  long long expirations;  // expirations taken since start
+};
+
+SimTimer simTimers[3];
+
+SimTimer &simTimer(unsigned int timerBase) {
+  switch (timerBase) {
+    case TIMER1_BASE:
+      return simTimers[0];
+    case TIMER2_BASE:
+      return simTimers[1];
+    default:
+      return simTimers[2];
+  }
+}
+
+long long counts(const SimTimer &t) {
+  return (host::nowNs() - t.start) * (TIMER3_FRQ / 1000) / 1000000;
+}
+
+long long bootNs = -1;
+
+}  // namespace
+
+namespace host {
+
+long long nowNs() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  long long ns = ts.tv_sec * 1000000000LL + ts.tv_nsec;
+  if (bootNs < 0) {
+    bootNs = ns;
+  }
+  return ns - bootNs;
+}
+
+bool timerDue(unsigned int timerBase) {
+  const SimTimer &t = simTimer(timerBase);
+  if (!t.running || !t.load) {
+    return false;
+  }
+  if (!t.periodic) {
+    return t.expirations == 0 && counts(t) >= t.load;
+  }
+  return counts(t) / t.load > t.expirations;
+}
+
+bool timerExpire(unsigned int timerBase) {
+  if (!timerDue(timerBase)) {
+    return false;
+  }
+  ++simTimer(timerBase).expirations;
+  return true;
+}
+
+}  // namespace host
+
+namespace timer {
+
+void load(unsigned int timerBase, unsigned int initialTimeMs) {
+  volatile unsigned int *addr =
+      (unsigned int *)(uintptr_t)(timerBase + LDR_OFFSET);
+  *addr = initialTimeMs * (TIMER3_FRQ / 1000);
+}
+
+void start(unsigned int timerBase) {
+  SimTimer &t = simTimer(timerBase);
+  t.load = *(volatile unsigned int *)(uintptr_t)(timerBase + LDR_OFFSET);
+  t.start = host::nowNs();
+  t.expirations = 0;
+  t.running = true;
+  t.periodic = true;
+}
+
+void stop(unsigned int timerBase) {
+  SimTimer &t = simTimer(timerBase);
+  if (t.running) {
+    t.stopped = getTick(timerBase);
+    t.running = false;
+  }
+}
+
+unsigned int getTick(unsigned int timerBase) {
+  const SimTimer &t = simTimer(timerBase);
+  if (!t.running || !t.load) {
+    return t.stopped;
+  }
+  if (!t.periodic) {
+    return t.load - (unsigned int)counts(t);
+  }
+  return t.load - counts(t) % t.load;
+}
+
+void startFreeRunning(unsigned int timerBase, unsigned int counts) {
+  stop(timerBase);
+  *(volatile unsigned int *)(uintptr_t)(timerBase + LDR_OFFSET) = counts;
+  start(timerBase);
+  simTimer(timerBase).periodic = false;
+}
+
+}  // namespace timer
@@ -0,0 +1,191 @@
+/*
+ * uart.cc - UART access of the driver on the host
+ *
+ * COM2 is the terminal: stdin is polled for input and output is written out
+ * as soon as it is buffered. COM1 stands in for the train controller and
+ * answers every sensor query with all sensors off; other commands are dropped.
+ * Alternatively COM1 is a link to another host kernel over a socket, see
+ * host::uartLink().
+ */
+
+#include "kern/uart.h"
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "host.h"
+#include "kern/arch/ts7200.h"
+#include "kern/common.h"
+#include "lib/queue.h"
+
+// sensor query for 5 modules and the bytes the controller replies with
+#define SENSOR_QUERY 0x85
+#define SENSOR_REPLY_LEN 10
+
+namespace {
+
+struct SimPort {
+  volatile sig_atomic_t rxReady;
+  volatile sig_atomic_t txWaiting;  // writers wait for the send buffer
+};
+
+SimPort com1, com2;
+
+volatile sig_atomic_t stdinOpen = 1;
+
+// socket of the COM1 link, -1 when COM1 is the simulated train controller
+int linkFd = -1;
+volatile sig_atomic_t linkOpen = 0;
+
+Queue<char, UART_BUFFER_SIZE> com1Replies;
+
+SimPort &simPort(unsigned int channel) {
+  return channel == COM1 ? com1 : com2;
+}
+
+bool readable(int fd) {
+  pollfd pfd{fd, POLLIN, 0};
+  return poll(&pfd, 1, 0) > 0;
+}
+
+void writeAll(int fd, const char *buf, int len) {
+  while (len > 0) {
+    int written = ::write(fd, buf, len);
+    if (written <= 0) {
+      return;
+    }
+    buf += written;
+    len -= written;
+  }
+}
+
+}  // namespace
+
+namespace host {
+
+void uartPoll() {
+  if (stdinOpen && readable(STDIN_FILENO)) {
+    com2.rxReady = 1;
+  }
+  if (linkOpen && readable(linkFd)) {
+    com1.rxReady = 1;
+  }
+}
+
+void uartLink(int fd) {
+  linkFd = fd;
+  linkOpen = 1;
+}
+
+bool uartPending(unsigned int channel) {
+  SimPort &port = simPort(channel);
+  return port.rxReady || port.txWaiting;
+}
+
+}  // namespace host
+
+KERN_INIT void UartDriver::init(unsigned int base, bool fifo, int speed,
+                                bool stp2, bool cts) {
+  this->base = base;
+  this->cts = cts;
+  recvBuffer.clear();
+  sendBuffer.clear();
+  readersHead = readersTail = nullptr;
+  writersHead = writersTail = nullptr;
+  flushersHead = flushersTail = nullptr;
+  ctsHigh = ctsReady = true;
+  simPort(base) = SimPort{0, 0};
+}
+
+void UartDriver::drainRx() {
+  SimPort &port = simPort(base);
+  port.rxReady = 0;
+  char buf[64];
+  if (base == COM1 && linkFd >= 0) {
+    while (linkOpen) {
+      int len = recv(linkFd, buf, sizeof(buf), MSG_DONTWAIT);
+      if (len == 0) {
+        linkOpen = 0;  // the peer has exited
+      }
+      if (len <= 0) {
+        break;
+      }
+      for (int i = 0; i < len; ++i) {
+        recvBuffer.enqueue(buf[i]);
+      }
+    }
+    return;
+  }
+  if (base == COM1) {
+    while (com1Replies.size() > 0) {
+      recvBuffer.enqueue(com1Replies.dequeue());
+    }
+    return;
+  }
+  while (stdinOpen && readable(STDIN_FILENO)) {
+    int len = ::read(STDIN_FILENO, buf, sizeof(buf));
+    if (len <= 0) {
+      stdinOpen = 0;
+      break;
+    }
+    for (int i = 0; i < len; ++i) {
+      recvBuffer.enqueue(buf[i]);
+    }
+  }
+}
+
+void UartDriver::fillTx() {
+  SimPort &port = simPort(base);
+  // a full buffer means the writer did not fit and is about to block
+  bool full = sendBuffer.size() == UART_BUFFER_SIZE;
+  char buf[256];
+  while (sendBuffer.size() > 0) {
+    int len = 0;
+    while (len < (int)sizeof(buf) && sendBuffer.size() > 0) {
+      buf[len++] = sendBuffer.dequeue();
+    }
+    if (base == COM2) {
+      ::write(STDOUT_FILENO, buf, len);
+      continue;
+    }
+    if (linkFd >= 0) {
+      writeAll(linkFd, buf, len);
+      continue;
+    }
+    for (int i = 0; i < len; ++i) {
+      if ((unsigned char)buf[i] == SENSOR_QUERY) {
+        for (int j = 0; j < SENSOR_REPLY_LEN; ++j) {
+          com1Replies.enqueue(0);
+        }
+        port.rxReady = 1;
+      }
+    }
+  }
+  // the send buffer is empty again; blocked writers are woken by the
+  // transmit interrupt as on the board
+  port.txWaiting = full || writersHead;
+  wakeFlushers();
+}
+
+unsigned int UartDriver::handleInterrupt() {
+  SimPort &port = simPort(base);
+  unsigned int val = 0;
+  if (port.rxReady) {
+    val |= RIS_MASK;
+    drainRx();
+    wakeReaders();
+  }
+  if (port.txWaiting) {
+    val |= TIS_MASK;
+    wakeWriters();
+    fillTx();
+  }
+  return val;
+}
+
+KERN_INIT void uartBootstrap() {
+  uartDrivers[0].init(COM1, false, 2400, true, true);
+  uartDrivers[1].init(COM2, true, 115200, false, false);
+}
@@ -0,0 +1,13 @@
+/*
+ * arch.h - register definitions of the board the kernel is built for
+ *
+ * Only the TS-7200 is built. Board-specific code lives in files ending in
+ * _<board>.cc and includes its board header directly.
+ */
+
+#ifndef KERN_ARCH_H_
+#define KERN_ARCH_H_
+
+#include "kern/arch/ts7200.h"
+
+#endif  // KERN_ARCH_H_
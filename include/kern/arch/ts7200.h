@@ -20,6 +20,7 @@
 
 #define IRQ_STATUS_OFFSET 0x0
 #define INT_ENABLE_OFFSET 0x10
+#define INT_ENABLE_CLEAR_OFFSET 0x14
 
 #define TIMER1_BASE 0x80810000
 #define TIMER2_BASE 0x80810020
@@ -32,6 +33,12 @@
 #define MODE_MASK 0x00000040
 #define CLKSEL_MASK 0x00000008
 #define CLR_OFFSET 0x0000000c  // no data, WO
+// periodic mode at 508 kHz
+#define TIMER_CTRL_START(base) (ENABLE_MASK | MODE_MASK | CLKSEL_MASK)
+
+// VIC line of the TIMER1 underflow interrupt
+#define TIMER1_VIC_BASE VIC1_BASE
+#define TIMER1_VIC_MASK (1 << 4)
 
 #define LED_ADDRESS 0x80840020
 #define LED_NONE 0x0
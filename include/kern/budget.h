@@ -0,0 +1,60 @@
+#ifndef KERN_BUDGET_H_
+#define KERN_BUDGET_H_
+
+#define BUDGET_MAX_TASKS 16
+// lowest priority above the idle task
+#define BUDGET_DEMOTED_PRIORITY 6
+
+/**
+ * CPU budgets for best-effort tasks. A budgeted task is charged for the time
+ * it runs in user mode. Once its budget for the current period is used up it
+ * is demoted to BUDGET_DEMOTED_PRIORITY, and at the start of the next period
+ * the budget is refilled and the task gets its own priority back.
+ */
+struct Budget {
+  int tid;  // -1 for a free slot
+  int priority;  // priority to restore on replenishment
+  int budgetUs;
+  int budget;  // TIMER3 counts per period
+  int period;  // ticks
+  int remaining;  // TIMER3 counts, negative once overspent
+  int nextReplenish;  // tick
+  bool demoted;
+  int demotedTick;
+  int throttles;  // periods in which the budget ran out
+  int throttledTicks;  // ticks spent demoted
+};
+
+struct TaskDescriptor;
+
+void budgetBootstrap();
+
+// charge curTask for the time since budgetStart(), demoting it if needed
+void budgetCharge();
+
+// note when curTask starts running in user mode
+void budgetStart();
+
+// refill the budgets whose period ends at tick
+void budgetReplenish(int tick);
+
+// TIMER3 counts task may still run before it is throttled, -1 if it has no
+// budget or is throttled already
+int budgetRemaining(TaskDescriptor *task);
+
+// the earliest tick a throttled task gets its priority back, -1 if none is
+// throttled
+int budgetNextReplenish();
+
+// the priority task runs at while within its budget
+int budgetOwnPriority(TaskDescriptor *task);
+
+// record a new own priority for task and return the priority it should run at
+// now, which stays BUDGET_DEMOTED_PRIORITY while it is throttled
+int budgetSetPriority(TaskDescriptor *task, int priority);
+
+void handleSetBudget();
+
+void handleBudgetStats();
+
+#endif  // KERN_BUDGET_H_
@@ -6,4 +6,11 @@
 
 typedef unsigned int addr_t;
 
+// kernel entry/exit, message passing and scheduling, linked contiguously so
+// that they can be locked into the I-cache
+#define KERN_HOT __attribute__((section(".text.kern_hot")))
+
+// runs once at boot or exit, linked away from the hot code
+#define KERN_INIT __attribute__((cold, section(".text.kern_init")))
+
 #endif  // KERN_COMMON_H_
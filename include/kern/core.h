@@ -0,0 +1,26 @@
+#ifndef KERN_CORE_H_
+#define KERN_CORE_H_
+
+/**
+ * Cores running the kernel. The board has one; the host build runs tasks on
+ * up to NUM_CORES threads (see host/cores.cc). The kernel itself is entered by
+ * one core at a time under a lock, so only what describes the running task of
+ * a core is kept per core: curTask and the budget run start. Ready tasks sit
+ * on the queue of the core that readied them, and a core with nothing of its
+ * own at a level steals from the others before it looks at a lower level.
+ * Core 0 takes every interrupt and runs the lowest level, the idle task.
+ */
+
+#ifndef NUM_CORES
+#define NUM_CORES 1
+#endif
+
+#if NUM_CORES > 1
+#define CORE_LOCAL thread_local
+// index of the core running this code
+extern CORE_LOCAL int coreId;
+#else
+#define CORE_LOCAL
+#endif
+
+#endif  // KERN_CORE_H_
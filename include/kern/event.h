@@ -14,6 +14,7 @@ class EventBuffer {
   EventBuffer();
   void push(TaskDescriptor *task);
   TaskDescriptor *pop();
+  bool isEmpty() const;
 };
 
 extern EventBuffer eventBuffers[NUM_EVENTS];
@@ -1,6 +1,8 @@
 #ifndef KERN_INTERRUPT_H_
 #define KERN_INTERRUPT_H_
 
+// the per-tick work besides the timer wheel: budgets and IRQ_TC3UI waiters
+void handleTick(int tick);
 void handleTC3UI();
 void handleUART(int eventType);
 
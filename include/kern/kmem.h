@@ -4,5 +4,6 @@
 extern char __text_start, __text_end;
 extern char __data_start, __data_end;
 extern char __bss_start, __bss_end;
+extern char __kern_hot_start, __kern_hot_end;
 
 #endif  // KERN_KMEM_H_
\ No newline at end of file
@@ -3,10 +3,18 @@
 
 #include "kern/syscall.h"
 
+void msgBootstrap();
+
 void msgSend();
 
 void msgReceive();
 
 void msgReply();
 
+// the calling task becomes the gateway that sends to remote tids go to
+void msgSetGateway();
+
+// the remote tid a task blocked on the gateway sent to, for the gateway
+void msgRemoteTarget();
+
 #endif  // KERN_MESSAGE_H_
\ No newline at end of file
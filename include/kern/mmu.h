@@ -0,0 +1,39 @@
+#ifndef KERN_MMU_H_
+#define KERN_MMU_H_
+
+#define NUM_SECTIONS 4096      // 4 GB of 1 MB sections
+#define SECTION_SHIFT 20
+#define L1_TABLE_ALIGN 0x4000  // the first-level table must be 16 KB aligned
+
+#define SDRAM_SIZE 0x2000000  // 32 MB
+#define DEVICE_START 0x80000000
+#define DEVICE_END 0x90000000
+
+#define ICACHE_MAX_LOCKED_WAYS 16  // 4 KB of the 16 KB I-cache
+
+/**
+ * Builds an identity-mapped first-level page table of 1 MB sections and turns
+ * on the MMU, I-cache, D-cache and write buffer. SDRAM is cacheable and
+ * bufferable, the device registers are strongly ordered, the tick page is
+ * read-only to user mode, and everything else faults.
+ *
+ * The ARM920T only uses the D-cache and write buffer with the MMU on, so
+ * setting the cache bits in CP15 c1 alone leaves data accesses uncached.
+ */
+void mmuBootstrap();
+
+/**
+ * Preloads the KERN_HOT code into the I-cache and locks the ways holding it,
+ * so that user code cannot evict the kernel entry/exit and message passing
+ * paths. Locks at most ICACHE_MAX_LOCKED_WAYS of the 64 ways; must run after
+ * mmuBootstrap().
+ */
+void icacheLockdown();
+
+/**
+ * Writes back the D-cache and restores the translation and cache settings
+ * RedBoot had before mmuBootstrap().
+ */
+void mmuExit();
+
+#endif  // KERN_MMU_H_
@@ -0,0 +1,43 @@
+#ifndef KERN_MSG_PROFILE_H_
+#define KERN_MSG_PROFILE_H_
+
+#define MSG_FLOW_PAIRS 512  // must be a power of two
+#define MSG_FLOW_MAX_PROBES 16
+
+struct TaskDescriptor;
+
+/**
+ * Message-flow profiler: per (sender, receiver) pair, counts messages and
+ * bytes and accumulates the time the sender spent send-blocked and
+ * reply-blocked, in TIMER3 counts. Also tracks the peak send queue depth of
+ * every task. The hooks are only called when built with ENABLE_MSG_PROFILE.
+ */
+struct MsgFlowPair {
+  int sender;
+  int receiver;
+  int count;
+  int bytes;
+  unsigned int sendBlocked;
+  unsigned int replyBlocked;
+};
+
+void msgProfileBootstrap();
+
+// sender was queued on receiver because receiver was not receive-blocked
+void msgProfileQueued(TaskDescriptor *sender, TaskDescriptor *receiver);
+
+// len bytes of sender's message were copied to receiver
+void msgProfileDelivered(TaskDescriptor *sender, TaskDescriptor *receiver,
+                         int len, bool queued);
+
+// replier unblocked sender with len bytes
+void msgProfileReplied(TaskDescriptor *sender, TaskDescriptor *replier,
+                       int len);
+
+void handleMsgFlowRead();
+
+void handleMsgQueueRead();
+
+void handleMsgFlowReset();
+
+#endif  // KERN_MSG_PROFILE_H_
@@ -0,0 +1,36 @@
+#ifndef KERN_PERIOD_H_
+#define KERN_PERIOD_H_
+
+/**
+ * Deadline monitoring for periodic tasks. A task declares its period and
+ * relative deadline in ticks; every waitNextPeriod() ends the current job,
+ * records its response time measured from the job's release, and sleeps
+ * until the next release. A period of 0 only monitors: each job is released
+ * when the previous one ends.
+ *
+ * A periodic task can also switch to the EDF class, in which case its ready
+ * queue level is ordered by the absolute deadline of each task's current job.
+ */
+struct PeriodInfo {
+  int tid;  // owner, -1 if the slot was never used
+  int period;
+  int deadline;
+  int releaseTick;
+  unsigned int releaseTime;  // TIMER3 counts, see tickPageNow()
+  int jobs;
+  int misses;    // jobs that ended after their deadline
+  int overruns;  // releases skipped because a job ran past the next one
+  unsigned int worstResponse;  // TIMER3 counts
+};
+
+void periodBootstrap();
+
+void handleSetPeriod();
+
+void handleWaitNextPeriod();
+
+void handlePeriodStats();
+
+void handleSetSchedClass();
+
+#endif  // KERN_PERIOD_H_
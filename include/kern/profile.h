@@ -0,0 +1,28 @@
+#ifndef KERN_PROFILE_H_
+#define KERN_PROFILE_H_
+
+#define PROFILE_BUCKETS 1024  // must be a power of two
+#define PROFILE_MAX_PROBES 16
+#define PROFILE_MIN_HZ 8  // TIMER1 is 16 bits wide
+#define PROFILE_MAX_HZ 10000
+
+/**
+ * Statistical profiler: TIMER1 interrupts at a configurable rate and the
+ * interrupted user pc and tid are counted in an open-addressing hash table.
+ * The kernel never runs with interrupts enabled, so every sample is a user pc.
+ */
+struct ProfileBucket {
+  unsigned int pc;
+  int tid;
+  int count;  // 0 for an empty bucket
+};
+
+void profileBootstrap();
+
+void handleTC1UI();
+
+void handleProfileControl();
+
+void handleProfileRead();
+
+#endif  // KERN_PROFILE_H_
@@ -0,0 +1,58 @@
+#ifndef KERN_SLEEP_H_
+#define KERN_SLEEP_H_
+
+#define WHEEL_BITS 6
+#define WHEEL_SLOTS (1 << WHEEL_BITS)  // 64
+#define WHEEL_MASK (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS 4  // covers 2^24 ticks, about 46 hours
+
+struct TaskDescriptor;
+
+/**
+ * Hierarchical timer wheel holding sleeping tasks.
+ *
+ * Level l has 64 slots of 64^l ticks each. A task is filed at the lowest
+ * level whose range covers its wake-up time, and is moved one level down
+ * whenever the wheel reaches the start of its slot. Insertion and expiry are
+ * both O(1) per task.
+ *
+ * A task that wakes up within a tick (wakeSubTick, tickless mode only) moves
+ * from level 0 to a list sorted by wakeSubTick when its tick starts.
+ */
+class TimerWheel {
+  int tick;
+  TaskDescriptor *slots[WHEEL_LEVELS][WHEEL_SLOTS];
+  TaskDescriptor *fine;  // due within the current tick
+
+  void cascade(int level);
+  void wake(TaskDescriptor *task);
+
+ public:
+  TimerWheel();
+  int now() const;
+  void insert(TaskDescriptor *task);
+  void insertFine(TaskDescriptor *task);
+  void advance();
+  // wake the tasks due by subTick TIMER3 counts into the current tick
+  void expireFine(unsigned int subTick);
+  // the next tick advance() has work for, at most 64 ticks ahead
+  int nextExpiry() const;
+  // wakeSubTick of the next task due within the current tick, -1 if none
+  int nextFine() const;
+};
+
+extern TimerWheel timerWheel;
+
+void sleepBootstrap();
+
+// block curTask until subTick TIMER3 counts into tick, or only yield if tick
+// has passed; r0 is set to the tick the task resumes at
+void sleepCurTask(int tick, unsigned int subTick = 0);
+
+void handleSleep();
+
+void handleSleepUntil();
+
+void handleSleepUs();
+
+#endif  // KERN_SLEEP_H_
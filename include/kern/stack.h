@@ -0,0 +1,44 @@
+#ifndef KERN_STACK_H_
+#define KERN_STACK_H_
+
+#include "kern/common.h"
+
+#define USER_STACK_START 0x1000000
+#define USER_STACK_REGION 0x800000  // 8 MB right below USER_STACK_START
+
+#define NUM_STACK_CLASSES 3
+#define STACK_LARGE_SIZE 0x20000  // 128 KB
+#define STACK_SMALL_SIZE 0x4000   // 16 KB
+#define STACK_TINY_SIZE 0x1000    // 4 KB
+
+#define STACK_CANARY 0xdeadbeef
+
+/**
+ * Hands out user stacks of a few fixed size classes from the stack region.
+ *
+ * New stacks are carved downwards from USER_STACK_START. A freed stack goes
+ * to the free list of its class, linked through its lowest word, and is
+ * reused by the next task of the same class. Both operations are O(1).
+ */
+class StackPool {
+  addr_t next;  // lowest address carved so far
+  addr_t freeLists[NUM_STACK_CLASSES];
+  int inUse;  // bytes held by live tasks
+
+ public:
+  StackPool();
+  addr_t alloc(int stackClass);
+  void free(addr_t top, int stackClass);
+  int getInUse() const;
+  int getCarved() const;
+
+  static bool isValid(int stackClass);
+  static int size(int stackClass);
+
+  static void fillCanary(addr_t top, int stackClass);
+  static int peakUsage(addr_t top, int stackClass);
+};
+
+extern StackPool stackPool;
+
+#endif  // KERN_STACK_H_
@@ -7,6 +7,9 @@ extern unsigned int idleTime;
 
 extern "C" unsigned int getIdleTime();
 
+// code of the highest priority pending interrupt, called by handleIRQ
+extern "C" unsigned int getIrqStatus();
+
 void sysBootstrap(addr_t lr);
 
 void kExit();
@@ -1,6 +1,7 @@
 #ifndef KERN_SYSCALL_CODE_H_
 #define KERN_SYSCALL_CODE_H_
 
+#define IRQ_TC1UI 4
 #define IRQ_TC3UI 51
 #define IRQ_UART1 52
 #define IRQ_UART2 54
@@ -20,6 +21,42 @@
 #define SYS_SHUTDOWN 74
 #define SYS_IDLE_TIME 75
 
+#define SYS_UART_READ 76
+#define SYS_UART_WRITE 77
+
+#define SYS_SLEEP 78
+#define SYS_SLEEP_UNTIL 79
+
+#define SYS_CREATE_ARGS 80
+#define SYS_STACK_IN_USE 81
+#define SYS_STACK_PROFILE 82
+
+#define SYS_PROFILE_CONTROL 83
+#define SYS_PROFILE_READ 84
+
+#define SYS_MSG_FLOW_READ 85
+#define SYS_MSG_QUEUE_READ 86
+#define SYS_MSG_FLOW_RESET 87
+
+#define SYS_SET_PERIOD 88
+#define SYS_WAIT_NEXT_PERIOD 89
+#define SYS_PERIOD_STATS 90
+
+#define SYS_SET_BUDGET 91
+#define SYS_BUDGET_STATS 92
+
+#define SYS_SET_SCHED_CLASS 93
+#define SYS_SET_PRIORITY 94
+
+#define SYS_SET_GATEWAY 95
+#define SYS_REMOTE_TARGET 96
+
+#define SYS_SLEEP_US 97
+
+#define SYS_UART_FLUSH 98
+
+#define SYS_TASK_ALIVE 99
+
 #define SYSCALL_FUNC(name, code) \
   .text;                         \
   .align 2;                      \
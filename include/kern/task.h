@@ -1,14 +1,21 @@
 #ifndef KERN_TASK_H_
 #define KERN_TASK_H_
 
-#include "lib/queue.h"
+#include "kern/common.h"
+#include "kern/core.h"
 #include "syscall.h"
 
-#define NUM_TASKS 64
+#define NUM_TASKS 256  // must be a power of two
+// a tid is generation * NUM_TASKS + descriptor index
+#define TASK_INDEX_MASK (NUM_TASKS - 1)
+// bit 30 is left clear; user code sets it for tids on the peer kernel
+#define TID_MASK 0x3fffffff
 #define NUM_PRIORITY_LEVELS 8
-#define USER_STACK_SIZE 0x20000  // 128 KB
 
-struct TaskDescriptor {
+// one ARM920T cache line
+#define CACHE_LINE_SIZE 32
+
+struct alignas(CACHE_LINE_SIZE) TaskDescriptor {
   enum class State {
     kActive = 0,
     kReady,
@@ -16,25 +23,52 @@ struct TaskDescriptor {
     kSendBlocked,
     kReceiveBlocked,
     kReplyBlocked,
-    kEventBlocked
+    kEventBlocked,
+    kIoBlocked,
+    kSleepBlocked
   };
 
-  int tid;
-  int parentTid;
-  int priority;
+  // hot: read by every schedule and message pass, kept in one cache line
   TaskDescriptor *nextReady;
-  TaskDescriptor *nextEventBlocked;
-  Queue<TaskDescriptor *, NUM_TASKS> sendQueue;
+  int priority;
   State state;
-  int retVal;
+  int tid;
+  // send-blocked tasks waiting on this task, linked through nextSend
+  TaskDescriptor *sendHead;
+  TaskDescriptor *sendTail;
+  TaskDescriptor *nextSend;
+  // links event-blocked, io-blocked and sleeping tasks; a task is blocked on
+  // at most one of them
+  TaskDescriptor *nextEventBlocked;
+
   Trapframe tf;
 
+  // cold
+  int parentTid;
+  int retVal;
+  int wakeTick;
+  addr_t stackTop;
+  int stackClass;
+  int deadline;  // absolute tick of the current job's deadline, if edf
+  bool edf;      // ordered by deadline within its ready queue level
+  unsigned short wakeSubTick;  // TIMER3 counts past wakeTick
+#if NUM_CORES > 1
+  int core;  // whose ready queue the task is on
+#endif
+
   TaskDescriptor(int parentTid, int priority, int tid);
   TaskDescriptor();
   void enqueueSender(TaskDescriptor *sender);
   TaskDescriptor *dequeueSender();
 };
 
+static_assert((NUM_TASKS & TASK_INDEX_MASK) == 0,
+              "NUM_TASKS should be a power of two");
+// the host build has 8-byte pointers, so only the target layout is checked
+static_assert(sizeof(void *) != 4 ||
+                  sizeof(TaskDescriptor) == 4 * CACHE_LINE_SIZE,
+              "TaskDescriptor should stay 4 cache lines");
+
 class PriorityQueues {
   TaskDescriptor *heads[NUM_PRIORITY_LEVELS];
   TaskDescriptor *tails[NUM_PRIORITY_LEVELS];
@@ -44,21 +78,50 @@ class PriorityQueues {
   void enqueue(TaskDescriptor *task);
   TaskDescriptor *dequeue(int priority);
   TaskDescriptor *dequeue();
+  bool remove(TaskDescriptor *task);
   bool isEmpty(int priority);
 };
 
+#if NUM_CORES > 1
+// a PriorityQueues per core, see kern/core.h; dequeue() may wait for another
+// core to ready a task
+class ReadyQueues {
+  PriorityQueues queues[NUM_CORES];
+
+ public:
+  void enqueue(TaskDescriptor *task);
+  TaskDescriptor *dequeue();
+  bool remove(TaskDescriptor *task);
+  // whether the running core has another task ready at priority
+  bool isEmpty(int priority);
+};
+#else
+typedef PriorityQueues ReadyQueues;
+#endif
+
 extern TaskDescriptor tasks[NUM_TASKS];
-extern TaskDescriptor *curTask;
-extern PriorityQueues readyQueues;
+extern CORE_LOCAL TaskDescriptor *curTask;
+extern ReadyQueues readyQueues;
 
 void taskBootstrap();
 
 void taskStart(void (*fn)());
 
+void taskStartArgs(void (*fn)(const void *), const void *args);
+
 void taskCreate(Trapframe *tf);
 
+void taskCreateArgs(Trapframe *tf);
+
+void taskStackProfile(Trapframe *tf);
+
+void handleSetPriority();
+
 void taskYield();
 
+// change the priority of task, moving it between ready queues if it is ready
+void taskSetPriority(TaskDescriptor *task, int priority);
+
 void taskExit();
 
 void taskDestroy();
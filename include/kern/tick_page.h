@@ -0,0 +1,76 @@
+#ifndef KERN_TICK_PAGE_H_
+#define KERN_TICK_PAGE_H_
+
+#include "kern/arch.h"
+
+// one page right above the user stacks, written only by the kernel
+#define TICK_PAGE_ADDR 0x1000000
+
+#define TICK_MS 10
+#define TICK_TIMER_LOAD (TICK_MS * (TIMER3_FRQ / 1000))  // TIMER3 counts per tick
+
+/**
+ * Published by the kernel on every tick interrupt so that tasks can read the
+ * time without a syscall.
+ *
+ * Read protocol: read seq, then the fields and TIMER3, then seq again, and
+ * retry if seq changed (a tick was published in between), then pass them to
+ * tickPageResolve(). TIMER3 counts down from load; at counter value c the time
+ * is offset + load - c TIMER3 counts past the start of tick.
+ *
+ * With the periodic tick, load is TICK_TIMER_LOAD and offset is 0, and a
+ * counter value above tickTimer means TIMER3 has reloaded for a tick the
+ * kernel has not published yet. In tickless mode TIMER3 runs free, loaded for
+ * the next deadline, and tickTimer is never exceeded.
+ */
+struct TickPage {
+  volatile unsigned int seq;
+  volatile int tick;
+  volatile unsigned int tickTimer;  // TIMER3 counter when tick was published
+  volatile int offset;  // TIMER3 counts past tick when TIMER3 was loaded
+  volatile unsigned int load;
+};
+
+#define TICK_PAGE ((TickPage *)TICK_PAGE_ADDR)
+
+/**
+ * @brief turn the fields of a page read together with TIMER3 into the time;
+ * on entry tick is the tick read from the page
+ *
+ * @param subTick TIMER3 counts elapsed since tick
+ */
+inline void tickPageResolve(int &tick, unsigned int &subTick, int offset,
+                            unsigned int load, unsigned int tickTimer,
+                            unsigned int counter) {
+  // unsigned, so that a free-running TIMER3 past 0 still counts up
+  unsigned int elapsed = offset + (load - counter);
+  if (counter > tickTimer) {
+    // TIMER3 reloaded but the tick interrupt has not been handled yet
+    elapsed += load;
+  }
+  if (elapsed >= TICK_TIMER_LOAD) {
+    tick += elapsed / TICK_TIMER_LOAD;
+    elapsed %= TICK_TIMER_LOAD;
+  }
+  subTick = elapsed;
+}
+
+void tickPageBootstrap();
+
+// publish tick, which TIMER3 has just reloaded for (periodic tick)
+void tickPagePublish(int tick);
+
+// publish tick without touching TIMER3, which keeps counting from its load
+void tickPageAdvance(int tick);
+
+// publish that TIMER3 was just loaded with load counts, offset counts past the
+// start of tick (tickless mode)
+void tickPageRebase(int tick, int offset, unsigned int load);
+
+// the kernel's view of clock::now
+void tickPageTime(int &tick, unsigned int &subTick);
+
+// the kernel's view of clock::now, in TIMER3 counts since boot
+unsigned int tickPageNow();
+
+#endif  // KERN_TICK_PAGE_H_
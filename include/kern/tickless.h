@@ -0,0 +1,33 @@
+#ifndef KERN_TICKLESS_H_
+#define KERN_TICKLESS_H_
+
+// longest TIMER3 load, which bounds the ticks caught up at once
+#define TICKLESS_MAX_TICKS 64
+// shortest TIMER3 load, so that a deadline already passed does not keep the
+// kernel from returning to user mode
+#define TICKLESS_MIN_COUNTS 16
+
+/**
+ * Tickless mode (ENABLE_TICKLESS): instead of interrupting every 10 ms, TIMER3
+ * runs free and is loaded for the next time the kernel has work: a sleeping
+ * task, a task waiting on IRQ_TC3UI, a throttled budget, or the end of the
+ * running task's budget or time slice. The tick count is derived from TIMER3
+ * on every kernel entry, so ticks still advance every 10 ms as seen by tasks.
+ */
+
+void ticklessBootstrap();
+
+// catch the timer wheel, the tick page and the per-tick work up with TIMER3;
+// called on every kernel entry
+void ticklessSync();
+
+// the TIMER3 deadline has passed
+void ticklessExpired();
+
+// the kernel has work subTick TIMER3 counts into tick
+void ticklessRequest(int tick, unsigned int subTick);
+
+// load TIMER3 for the earliest deadline before curTask runs
+void ticklessArm();
+
+#endif  // KERN_TICKLESS_H_
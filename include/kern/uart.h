@@ -0,0 +1,54 @@
+#ifndef KERN_UART_H_
+#define KERN_UART_H_
+
+#include "lib/queue.h"
+
+#define UART_BUFFER_SIZE 8192
+#define NUM_UARTS 2
+
+struct TaskDescriptor;
+
+class UartDriver {
+  unsigned int base;
+  bool cts;       // whether CTS flow control is used (COM1)
+  bool ctsHigh;   // last observed CTS level
+  bool ctsReady;  // CTS reasserted since the last byte was sent
+
+  Queue<char, UART_BUFFER_SIZE> recvBuffer;
+  Queue<char, UART_BUFFER_SIZE> sendBuffer;
+
+  // tasks blocked on an empty recvBuffer / a full sendBuffer, linked through
+  // nextEventBlocked
+  TaskDescriptor *readersHead, *readersTail;
+  TaskDescriptor *writersHead, *writersTail;
+  // tasks blocked until sendBuffer has drained
+  TaskDescriptor *flushersHead, *flushersTail;
+
+  void drainRx();
+  void fillTx();
+  void wakeReaders();
+  void wakeWriters();
+  void wakeFlushers();
+  int copyToTask(TaskDescriptor *task);
+  bool copyFromTask(TaskDescriptor *task);
+
+ public:
+  UartDriver();
+  void init(unsigned int base, bool fifo, int speed, bool stp2, bool cts);
+  unsigned int handleInterrupt();
+  bool read(TaskDescriptor *task);
+  bool write(TaskDescriptor *task);
+  bool flush(TaskDescriptor *task);
+};
+
+extern UartDriver uartDrivers[NUM_UARTS];
+
+void uartBootstrap();
+
+void handleUartRead();
+
+void handleUartWrite();
+
+void handleUartFlush();
+
+#endif  // KERN_UART_H_
@@ -6,25 +6,21 @@
 #include "user/task.h"
 
 template <typename M>
-void sendWorker() {
-  int parentTid, recvTid, ticks;
+struct SendArgs {
+  int recvTid;
+  int ticks;
   M msg;
-  receive(parentTid, recvTid);
-  reply(parentTid);
-  receive(parentTid, msg);
-  reply(parentTid);
-  receive(parentTid, ticks);
-  reply(parentTid);
-  clock::delay(ticks);
-  send(recvTid, msg);
+};
+
+template <typename M>
+void sendWorker(const SendArgs<M> *args) {
+  clock::delay(args->ticks);
+  send(args->recvTid, args->msg);
 }
 
 template <typename M>
 void delaySend(int tid, const M &msg, int ticks) {
-  int worker = create(4, sendWorker<M>);
-  send(worker, tid);
-  send(worker, msg);
-  send(worker, ticks);
+  create(4, sendWorker<M>, SendArgs<M>{tid, ticks, msg}, STACK_TINY);
 }
 
 template <typename M>
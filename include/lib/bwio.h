@@ -1,19 +1,15 @@
 #ifndef KERN_LIB_BWIO_H_
 #define KERN_LIB_BWIO_H_
 
-#include "kern/arch/ts7200.h"
+#include "kern/arch.h"
 
-typedef const char *va_list;
+typedef __builtin_va_list va_list;
 
-#define __va_argsiz(t) \
-  (((sizeof(t) + sizeof(int) - 1) / sizeof(int)) * sizeof(int))
+#define va_start(ap, pN) __builtin_va_start(ap, pN)
 
-#define va_start(ap, pN) ((ap) = ((va_list)__builtin_next_arg(pN)))
+#define va_end(ap) __builtin_va_end(ap)
 
-#define va_end(ap) ((void)0)
-
-#define va_arg(ap, t) \
-  (((ap) = (ap) + __va_argsiz(t)), *((t *)(void *)((ap)-__va_argsiz(t))))
+#define va_arg(ap, t) __builtin_va_arg(ap, t)
 
 #define ON 1
 #define OFF 0
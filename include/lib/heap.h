@@ -64,6 +64,7 @@ class MinHeap {
         break;
       }
       swap(smaller, i);
+      i = smaller;
     }
   }
 
@@ -79,4 +80,108 @@ class MinHeap {
   int size() const { return sz; }
 };
 
+/**
+ * A min-heap of up to cap keys, each named by an id in [0, cap) that stays
+ * valid while the key moves in the heap, so that any key can be removed or
+ * changed in O(log n) without searching for it.
+ */
+template <typename T, int cap>
+class IndexedMinHeap {
+  T keys[cap];    // by id
+  int heap[cap];  // ids
+  int pos[cap];   // index of each id in heap, -1 if not in it
+  int sz = 0;
+
+  int parent(int i) { return (i - 1) / 2; }
+
+  int left(int i) { return (2 * i + 1); }
+
+  int right(int i) { return (2 * i + 2); }
+
+  bool less(int i, int j) { return keys[heap[i]] < keys[heap[j]]; }
+
+  void swap(int i, int j) {
+    int temp = heap[i];
+    heap[i] = heap[j];
+    heap[j] = temp;
+    pos[heap[i]] = i;
+    pos[heap[j]] = j;
+  }
+
+  void siftUp(int i) {
+    while (i != 0 && less(i, parent(i))) {
+      swap(i, parent(i));
+      i = parent(i);
+    }
+  }
+
+  void siftDown(int i) {
+    while (true) {
+      int l = left(i);
+      int r = right(i);
+      int smaller = i;
+      if (l < sz && less(l, smaller)) {
+        smaller = l;
+      }
+      if (r < sz && less(r, smaller)) {
+        smaller = r;
+      }
+      if (smaller == i) {
+        break;
+      }
+      swap(smaller, i);
+      i = smaller;
+    }
+  }
+
+ public:
+  IndexedMinHeap() {
+    for (int i = 0; i < cap; ++i) {
+      pos[i] = -1;
+    }
+  }
+
+  bool contains(int id) const { return pos[id] >= 0; }
+
+  void insert(int id, T key) {
+    assert(0 <= id && id < cap && !contains(id));
+    keys[id] = key;
+    heap[sz] = id;
+    pos[id] = sz;
+    siftUp(sz++);
+  }
+
+  // decrease or increase the key of id
+  void update(int id, T key) {
+    assert(contains(id));
+    keys[id] = key;
+    siftUp(pos[id]);
+    siftDown(pos[id]);
+  }
+
+  void remove(int id) {
+    assert(contains(id));
+    int i = pos[id];
+    swap(i, --sz);
+    pos[id] = -1;
+    if (i < sz) {
+      siftUp(i);
+      siftDown(i);
+    }
+  }
+
+  // -1 if empty
+  int minId() const { return sz > 0 ? heap[0] : -1; }
+
+  const T *peekMin() const { return sz > 0 ? &keys[heap[0]] : nullptr; }
+
+  void deleteMin() {
+    if (sz > 0) {
+      remove(heap[0]);
+    }
+  }
+
+  int size() const { return sz; }
+};
+
 #endif  // LIB_HASHTABLE_H_
\ No newline at end of file
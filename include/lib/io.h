@@ -1,17 +1,9 @@
 #ifndef KERN_LIB_IO_H_
 #define KERN_LIB_IO_H_
 
-#include "kern/arch/ts7200.h"
+#include "kern/arch.h"
 
-typedef const char *va_list;
-
-void ioBootstrap(int _uart1Tid, int _uart2Tid);
-
-int setfifo(unsigned int channel, int state);
-
-int setspeed(unsigned int channel, int speed);
-
-int setstp2(unsigned int channel, int select);
+typedef __builtin_va_list va_list;
 
 char a2i(char ch, const char **src, int base, int *nump);
 
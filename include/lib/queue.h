@@ -28,6 +28,11 @@ class Queue {
     return val;
   }
 
+  void clear() {
+    head = 0;
+    sz = 0;
+  }
+
   int size() const { return sz; }
 };
 
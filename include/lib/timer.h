@@ -1,7 +1,7 @@
 #ifndef LIB_TIMER_H_
 #define LIB_TIMER_H_
 
-#include "kern/arch/ts7200.h"
+#include "kern/arch.h"
 namespace timer {
 
 void load(unsigned int timerBase, unsigned int initialTimeMs);
@@ -9,6 +9,10 @@ void start(unsigned int timerBase);
 void stop(unsigned int timerBase);
 unsigned int getTick(unsigned int timerBase);
 
+// restart the timer counting down from counts in free-running mode: it
+// interrupts once on reaching 0 and then keeps counting down from 0xffffffff
+void startFreeRunning(unsigned int timerBase, unsigned int counts);
+
 }  // namespace timer
 
 #endif  // LIB_TIMER_H_
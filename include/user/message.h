@@ -1,14 +1,38 @@
 #ifndef USER_MESSAGE_H_
 #define USER_MESSAGE_H_
 
+// set in a tid to address the task with that tid on the peer kernel; such
+// sends go to the gateway task, see remote.h
+#define REMOTE_TID_FLAG 0x40000000
+
 extern "C" {
 int send(int tid, const void *msg, int msgLen, void *reply, int replyLen);
 
 int receive(int *tid, void *msg, int msgLen);
 
 int reply(int tid, const void *reply, int replyLen);
+
+/**
+ * @brief make the calling task the gateway, which receives every send to a
+ * tid with REMOTE_TID_FLAG set
+ *
+ * @return tid of the previous gateway, -1 if there was none
+ */
+int setGateway();
+
+/**
+ * @brief for the gateway: the peer tid that a task blocked on it sent to
+ *
+ * @return the tid without REMOTE_TID_FLAG, -1 if tid is not blocked on a
+ * remote send, -2 if the caller is not the gateway
+ */
+int remoteTarget(int tid);
 }
 
+// negative tids, such as a failed whoIs(), are passed through, so that a send
+// to one fails locally with -1
+inline int remoteTid(int tid) { return tid < 0 ? tid : tid | REMOTE_TID_FLAG; }
+
 template <typename M, typename R>
 int send(int tid, const M &msg, R &reply) {
   return send(tid, &msg, sizeof(M), &reply, sizeof(R));
@@ -0,0 +1,66 @@
+#ifndef USER_PROFILE_H_
+#define USER_PROFILE_H_
+
+struct ProfileSample {
+  unsigned int pc;
+  int tid;
+  int count;
+};
+
+// message flow from sender to receiver, blocked times in TIMER3 counts
+struct MsgFlow {
+  int sender;
+  int receiver;
+  int count;
+  int bytes;  // message and reply bytes copied
+  unsigned int sendBlocked;
+  unsigned int replyBlocked;
+};
+
+struct MsgQueuePeak {
+  int tid;
+  int peak;  // most senders ever queued on tid at once
+};
+
+extern "C" {
+/**
+ * @brief start sampling the running task's pc hz times per second, discarding
+ * earlier samples, or stop sampling if hz is 0
+ *
+ * @return number of samples taken since the last start, -1 if hz is out of
+ * range (8 to 10000)
+ */
+int profileControl(int hz);
+
+/**
+ * @brief read one bucket of the pc histogram
+ *
+ * @return 0 if filled, -1 if the bucket is empty, -2 if index is out of range
+ */
+int profileRead(int index, ProfileSample *sample);
+
+/**
+ * @brief read one sender/receiver pair of the message-flow profile; always
+ * empty unless the kernel is built with ENABLE_MSG_PROFILE
+ *
+ * @return 0 if filled, -1 if the slot is empty, -2 if index is out of range
+ */
+int msgFlowRead(int index, MsgFlow *flow);
+
+/**
+ * @brief read the peak send queue depth of the task in descriptor slot index
+ *
+ * @return 0 if filled, -1 if no sender was ever queued on the task, -2 if
+ * index is out of range
+ */
+int msgQueueRead(int index, MsgQueuePeak *peak);
+
+/**
+ * @brief clear the message-flow profile
+ *
+ * @return 0
+ */
+int msgFlowReset();
+}
+
+#endif  // USER_PROFILE_H_
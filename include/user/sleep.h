@@ -0,0 +1,53 @@
+#ifndef USER_SLEEP_H_
+#define USER_SLEEP_H_
+
+struct PeriodStats {
+  int tid;
+  int period;    // ticks, 0 if only monitored
+  int deadline;  // ticks after each release
+  int jobs;
+  int misses;
+  int overruns;
+  unsigned int worstResponse;  // TIMER3 counts from release to the job's end
+};
+
+extern "C" {
+int sleepFor(int ticks);
+
+int sleepUntil(int tick);
+
+/**
+ * @brief sleep for us microseconds; without tickless mode the task wakes on
+ * the first tick after that
+ *
+ * @return the tick it woke up at, -2 if us < 0
+ */
+int sleepForUs(int us);
+
+/**
+ * @brief declare the calling task periodic, releasing a job every period
+ * ticks from now that must end within deadline ticks; with period 0 each job
+ * is released when the previous one ends. Resets the task's statistics.
+ *
+ * @return 0, -1 if period is negative or deadline is not in (0, period]
+ */
+int setPeriod(int period, int deadline);
+
+/**
+ * @brief end the current job and sleep until the next release, skipping any
+ * releases that have already passed
+ *
+ * @return the release tick, -1 if the task has not called setPeriod
+ */
+int waitNextPeriod();
+
+/**
+ * @brief read the deadline statistics of the task in descriptor slot index
+ *
+ * @return 0 if filled, -1 if the task is not periodic, -2 if index is out of
+ * range
+ */
+int periodStats(int index, PeriodStats *stats);
+}
+
+#endif  // USER_SLEEP_H_
@@ -1,6 +1,6 @@
-#ifndef USER_EVENT_H_
-#define USER_EVENT_H_
+#ifndef USER_SYS_H_
+#define USER_SYS_H_
 
 extern "C" int shutdown();
 
-#endif  // USER_EVENT_H_
+#endif  // USER_SYS_H_
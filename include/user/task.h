@@ -1,8 +1,42 @@
 #ifndef USER_TASK_H_
 #define USER_TASK_H_
 
+// stack size classes for create() and createArgs()
+#define STACK_LARGE 0  // 128 KB, for tasks with big locals such as track data
+#define STACK_SMALL 1  // 16 KB, for servers
+#define STACK_TINY 2   // 4 KB, for notifiers, couriers and workers
+
+// scheduling classes for setSchedClass()
+#define SCHED_FIXED 0  // FIFO within the task's priority
+#define SCHED_EDF 1    // earliest deadline first within the task's priority
+
+struct StackProfile {
+  int tid;
+  int size;  // bytes
+  int peak;  // deepest usage in bytes, -1 unless built with stack profiling
+};
+
+struct BudgetStats {
+  int tid;
+  int priority;  // priority while within budget
+  int budget;    // us per period
+  int period;    // ticks
+  int throttles;       // periods in which the budget ran out
+  int throttledTicks;  // ticks spent demoted
+  int demoted;
+};
+
 extern "C" {
-int create(int priority, void (*function)());
+/**
+ * @brief create a task running function on a stack of the given class
+ *
+ * @return tid, -1 for invalid priority, -2 if out of task descriptors, -3 for
+ * invalid stack class, -4 if out of stack memory
+ */
+int create(int priority, void (*function)(), int stackClass = STACK_LARGE);
+
+int createArgs(int priority, void (*function)(const void *), const void *args,
+               int argsLen, int stackClass = STACK_LARGE);
 
 int myTid();
 
@@ -13,5 +47,77 @@ void yield();
 void exit();
 
 void destroy();
+
+/**
+ * @brief whether tid names a task that has not exited or been destroyed
+ *
+ * @return 1 if it is alive, 0 otherwise
+ */
+int taskAlive(int tid);
+
+/**
+ * @brief total bytes of stack held by live tasks
+ */
+int stackInUse();
+
+/**
+ * @brief report the stack of the task in the given task descriptor slot
+ *
+ * @return 0 if filled, -1 if the slot holds no live task, -2 if index is out of
+ * range
+ */
+int stackProfile(int index, StackProfile *profile);
+
+/**
+ * @brief limit the calling task or one of its children to budgetUs of CPU
+ * time every period ticks; once the budget is used up the task runs at
+ * priority 6 until the next period. A budget of 0 removes the limit.
+ *
+ * @return 0, -1 if tid is not the caller or its child, -2 for an invalid
+ * budget or period, -3 if too many tasks are budgeted
+ */
+int setBudget(int tid, int budgetUs, int period);
+
+/**
+ * @brief read budget slot index
+ *
+ * @return 0 if filled, -1 if the slot is free, -2 if index is out of range
+ */
+int budgetStats(int index, BudgetStats *stats);
+
+/**
+ * @brief switch the calling task between FIFO and earliest-deadline-first
+ * ordering within its priority. EDF tasks run before FIFO tasks of the same
+ * priority, earliest deadline of the current job (see setPeriod) first.
+ *
+ * @return 0, -1 for SCHED_EDF if the task has not called setPeriod, -2 for an
+ * invalid class
+ */
+int setSchedClass(int schedClass);
+
+/**
+ * @brief change the priority of the calling task or one of its children; a
+ * ready task moves to the back of its new level, a blocked task keeps its
+ * place in whatever it is blocked on
+ *
+ * @return the previous priority, -1 for invalid priority, -2 if tid is not the
+ * caller or its child
+ */
+int setPriority(int tid, int priority);
 }
+
+/**
+ * @brief create a task that starts with a copy of args on its own stack
+ *
+ * @return tid, -1 for invalid priority, -2 if out of task descriptors, -3 if
+ * args is too large (256 bytes at most) or the stack class is invalid, -4 if out
+ * of stack memory
+ */
+template <typename A>
+int create(int priority, void (*function)(const A *), const A &args,
+           int stackClass = STACK_LARGE) {
+  return createArgs(priority, (void (*)(const void *))function, &args,
+                    sizeof(A), stackClass);
+}
+
 #endif  // USER_TASK_H_
@@ -0,0 +1,18 @@
+#ifndef USER_UART_H_
+#define USER_UART_H_
+
+extern "C" {
+int uartRead(unsigned int channel, char *buf, int len);
+
+int uartWrite(unsigned int channel, const char *buf, int len);
+
+/**
+ * @brief block until everything written to channel so far has left the send
+ * buffer; up to a FIFO's worth of bytes may still be on their way out
+ *
+ * @return 0, -1 if channel is not a UART
+ */
+int uartFlush(unsigned int channel);
+}
+
+#endif  // USER_UART_H_
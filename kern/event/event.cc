@@ -1,6 +1,9 @@
 #include "kern/event.h"
 
+#include "kern/sleep.h"
+#include "kern/syscall_code.h"
 #include "kern/task.h"
+#include "kern/tickless.h"
 #include "lib/assert.h"
 
 EventBuffer::EventBuffer() : head{nullptr} {}
@@ -18,19 +21,26 @@ TaskDescriptor *EventBuffer::pop() {
   return temp;
 }
 
+bool EventBuffer::isEmpty() const { return !head; }
+
 EventBuffer eventBuffers[NUM_EVENTS];
 
-void eventBootstrap() {
+KERN_INIT void eventBootstrap() {
   for (int i = 0; i < NUM_EVENTS; ++i) {
     eventBuffers[i] = EventBuffer();
   }
 }
 
-void handleAwaitEvent() {
+KERN_HOT void handleAwaitEvent() {
   int eventType = curTask->tf.r0;
   kAssert(0 <= eventType && eventType < NUM_EVENTS);
   curTask->state = TaskDescriptor::State::kEventBlocked;
 
   // push task
   eventBuffers[eventType].push(curTask);
+#if ENABLE_TICKLESS
+  if (eventType == IRQ_TC3UI) {
+    ticklessRequest(timerWheel.now() + 1, 0);
+  }
+#endif
 }
@@ -1,37 +1,48 @@
 
 #include "../user/include/boot.h"
+#include "kern/budget.h"
 #include "kern/common.h"
 #include "kern/event.h"
+#include "kern/message.h"
+#include "kern/mmu.h"
+#include "kern/msg_profile.h"
+#include "kern/period.h"
+#include "kern/profile.h"
+#include "kern/sleep.h"
 #include "kern/sys.h"
 #include "kern/syscall.h"
 #include "kern/task.h"
+#include "kern/uart.h"
 #include "lib/bwio.h"
+#include "user/task.h"
 
 int main() {
   // store main's return address for exiting the kernel
-  addr_t lr;
-  asm volatile("mov %r0, lr" : "=r"(lr));
+  addr_t lr = (addr_t)(unsigned long)__builtin_return_address(0);
 
   sysBootstrap(lr);
   taskBootstrap();
+  budgetBootstrap();
   eventBootstrap();
+  msgBootstrap();
+  uartBootstrap();
+  sleepBootstrap();
+  periodBootstrap();
+  profileBootstrap();
+  msgProfileBootstrap();
 
 #if ENABLE_CACHE
-  // clean and invalidate cache
-  asm volatile("mcr p15, 0, r0, c7, c14");  // clean and invalidate d-cache
-  asm volatile("mcr p15, 0, r0, c7, c5");   // invalidate i-cache
-
-  // enable cache
-  unsigned int c1;
-  asm volatile("mrc p15, 0, %r0, c1, c0" : "=r"(c1));
-  c1 |= 0b0001'0000'0000'0100;
-  asm volatile("mcr p15, 0, %r0, c1, c0" : : "r"(c1));
+  mmuBootstrap();
+#if ENABLE_ICACHE_LOCK
+  icacheLockdown();
+#endif
 #endif
 
   // add first user task
   Trapframe tf;
   tf.r0 = BOOT_PRIORITY;
-  tf.r1 = (unsigned int)boot;
+  tf.r1 = (unsigned int)(unsigned long)boot;
+  tf.r2 = STACK_LARGE;
   taskCreate(&tf);
 
   while (true) {
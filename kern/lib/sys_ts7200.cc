@@ -1,8 +1,11 @@
 #include "kern/sys.h"
 
 #include "kern/arch/ts7200.h"
+#include "kern/mmu.h"
 #include "kern/syscall.h"
+#include "lib/assert.h"
 #include "lib/bwio.h"
+#include "lib/math.h"
 #include "lib/timer.h"
 
 #define SWI_ENTRY (volatile unsigned int *)0x08
@@ -14,7 +17,7 @@ addr_t exitAddr;
 
 unsigned int idleTime;
 
-void sysBootstrap(addr_t lr) {
+KERN_INIT void sysBootstrap(addr_t lr) {
   idleTime = 0;
   exitAddr = lr;
 
@@ -43,7 +46,26 @@ void sysBootstrap(addr_t lr) {
   *(volatile unsigned int *)(DEVICE_CFG) |= 1;
 }
 
-void kExit() {
+extern "C" KERN_HOT unsigned int getIrqStatus() {
+  unsigned int vic1Status =
+      *(volatile unsigned int *)(VIC1_BASE + IRQ_STATUS_OFFSET);
+  unsigned int vic2Status =
+      *(volatile unsigned int *)(VIC2_BASE + IRQ_STATUS_OFFSET);
+  kAssert(vic1Status != 0 || vic2Status != 0);
+
+  unsigned int result = -1;
+  if (vic1Status != 0) {
+    result = log2(vic1Status);
+  } else {
+    result = log2(vic2Status) + 32;
+  }
+  kAssert(0 <= result && result < 64);
+  // bwprintf(COM2, "irq: %d\n\r", result);
+  return result;
+}
+
+KERN_INIT void kExit() {
+  timer::stop(TIMER1_BASE);
   timer::stop(TIMER2_BASE);
   timer::stop(TIMER3_BASE);
 
@@ -51,6 +73,10 @@ void kExit() {
   *(volatile unsigned int *)(UART1_BASE + UART_CTRL_OFFSET) = 1;
   *(volatile unsigned int *)(UART2_BASE + UART_CTRL_OFFSET) = 1;
 
+#if ENABLE_CACHE
+  mmuExit();
+#endif
+
   asm volatile(
       "mov lr, %[value]\n\t"
       "bx lr"
@@ -1,10 +1,21 @@
 #include "kern/message.h"
 
+#include "kern/msg_profile.h"
 #include "kern/syscall.h"
 #include "kern/task.h"
 #include "lib/assert.h"
+#include "user/message.h"
 
-int msgCopy(const char *src, int srcLen, char *dst, int dstLen) {
+namespace {
+
+// receives every send to a tid with REMOTE_TID_FLAG set, -1 if none
+int gatewayTid;
+
+}  // namespace
+
+void msgBootstrap() { gatewayTid = -1; }
+
+KERN_HOT int msgCopy(const char *src, int srcLen, char *dst, int dstLen) {
   if (srcLen < dstLen) {
     dstLen = srcLen;
   }
@@ -14,7 +25,7 @@ int msgCopy(const char *src, int srcLen, char *dst, int dstLen) {
   return dstLen;
 }
 
-void msgCopy(TaskDescriptor *sender, TaskDescriptor *receiver) {
+KERN_HOT void msgCopy(TaskDescriptor *sender, TaskDescriptor *receiver) {
   int *senderTid = (int *)receiver->tf.r0;
   *senderTid = sender->tid;
 
@@ -27,34 +38,44 @@ void msgCopy(TaskDescriptor *sender, TaskDescriptor *receiver) {
   receiver->tf.r0 = copiedLen;
 }
 
-void msgSend() {
+KERN_HOT void msgSend() {
   int tid = curTask->tf.r0;
+  // the sender's r0 keeps the remote tid until the reply, which is where
+  // msgRemoteTarget() finds it; negative tids have the flag bit set too
+  if (tid >= 0 && (tid & REMOTE_TID_FLAG)) {
+    tid = gatewayTid;
+  }
 
   // TODO: check condition for return -2
 
-  if (!isTidValid(tid)) {
+  TaskDescriptor *sender = curTask;
+  TaskDescriptor *receiver = getTd(tid);
+  if (!receiver) {
     curTask->tf.r0 = -1;
     taskYield();
     return;
   }
 
-  TaskDescriptor *sender = curTask;
-  TaskDescriptor *receiver = getTd(tid);
-
   if (receiver->state == TaskDescriptor::State::kReceiveBlocked) {
     // receiver first
     receiver->state = TaskDescriptor::State::kReady;
     readyQueues.enqueue(receiver);
     sender->state = TaskDescriptor::State::kReplyBlocked;
     msgCopy(sender, receiver);
+#if ENABLE_MSG_PROFILE
+    msgProfileDelivered(sender, receiver, receiver->tf.r0, false);
+#endif
   } else {
     // sender first
     sender->state = TaskDescriptor::State::kSendBlocked;
     receiver->enqueueSender(sender);
+#if ENABLE_MSG_PROFILE
+    msgProfileQueued(sender, receiver);
+#endif
   }
 }
 
-void msgReceive() {
+KERN_HOT void msgReceive() {
   TaskDescriptor *sender = curTask->dequeueSender();
   TaskDescriptor *receiver = curTask;
 
@@ -63,6 +84,9 @@ void msgReceive() {
     kAssert(sender->state == TaskDescriptor::State::kSendBlocked);
     sender->state = TaskDescriptor::State::kReplyBlocked;
     msgCopy(sender, receiver);
+#if ENABLE_MSG_PROFILE
+    msgProfileDelivered(sender, receiver, receiver->tf.r0, true);
+#endif
     taskYield();
   } else {
     // receiver first
@@ -70,17 +94,17 @@ void msgReceive() {
   }
 }
 
-void msgReply() {
+KERN_HOT void msgReply() {
   int tid = (int)curTask->tf.r0;
   const char *reply = (const char *)curTask->tf.r1;
   int replyLen = (int)curTask->tf.r2;
 
-  if (!isTidValid(tid)) {
+  TaskDescriptor *sender = getTd(tid);
+  if (!sender) {
     curTask->tf.r0 = -1;
     taskYield();
     return;
   }
-  TaskDescriptor *sender = getTd(tid);
   if (sender->state != TaskDescriptor::State::kReplyBlocked) {
     curTask->tf.r0 = -2;
     taskYield();
@@ -96,6 +120,31 @@ void msgReply() {
 
   curTask->tf.r0 = copiedLen;
   sender->tf.r0 = copiedLen;
+#if ENABLE_MSG_PROFILE
+  msgProfileReplied(sender, curTask, copiedLen);
+#endif
 
   taskYield();
 }
+
+void msgSetGateway() {
+  curTask->tf.r0 = gatewayTid;
+  gatewayTid = curTask->tid;
+}
+
+void msgRemoteTarget() {
+  if (curTask->tid != gatewayTid) {
+    curTask->tf.r0 = -2;
+    return;
+  }
+  TaskDescriptor *sender = getTd((int)curTask->tf.r0);
+  bool blocked = sender &&
+                 (sender->state == TaskDescriptor::State::kSendBlocked ||
+                  sender->state == TaskDescriptor::State::kReplyBlocked);
+  int target = blocked ? (int)sender->tf.r0 : -1;
+  if (target < 0 || !(target & REMOTE_TID_FLAG)) {
+    curTask->tf.r0 = -1;
+    return;
+  }
+  curTask->tf.r0 = target & ~REMOTE_TID_FLAG;
+}
@@ -0,0 +1,148 @@
+#include "kern/msg_profile.h"
+
+#include "kern/task.h"
+#include "kern/tick_page.h"
+#include "user/profile.h"
+
+namespace {
+
+MsgFlowPair pairs[MSG_FLOW_PAIRS];
+bool used[MSG_FLOW_PAIRS];
+
+// per descriptor index
+unsigned int blockedSince[NUM_TASKS];
+int queueOwner[NUM_TASKS];  // tid the depth below belongs to
+int queueDepth[NUM_TASKS];
+int queuePeak[NUM_TASKS];
+
+MsgFlowPair *findPair(int sender, int receiver) {
+  unsigned int index = ((unsigned int)sender * 2654435761u ^
+                        (unsigned int)receiver) &
+                       (MSG_FLOW_PAIRS - 1);
+  for (int i = 0; i < MSG_FLOW_MAX_PROBES; ++i) {
+    MsgFlowPair &pair = pairs[index];
+    if (!used[index]) {
+      used[index] = true;
+      pair = MsgFlowPair{sender, receiver, 0, 0, 0, 0};
+      return &pair;
+    }
+    if (pair.sender == sender && pair.receiver == receiver) {
+      return &pair;
+    }
+    index = (index + 1) & (MSG_FLOW_PAIRS - 1);
+  }
+  // table too crowded around this pair; drop it
+  return nullptr;
+}
+
+int &depth(TaskDescriptor *task) {
+  int index = task->tid & TASK_INDEX_MASK;
+  if (queueOwner[index] != task->tid) {
+    // the descriptor was reused since the last message
+    queueOwner[index] = task->tid;
+    queueDepth[index] = 0;
+    queuePeak[index] = 0;
+  }
+  return queueDepth[index];
+}
+
+}  // namespace
+
+KERN_INIT void msgProfileBootstrap() {
+  for (int i = 0; i < MSG_FLOW_PAIRS; ++i) {
+    used[i] = false;
+  }
+  for (int i = 0; i < NUM_TASKS; ++i) {
+    queueOwner[i] = -1;
+    queueDepth[i] = 0;
+    queuePeak[i] = 0;
+  }
+}
+
+void msgProfileQueued(TaskDescriptor *sender, TaskDescriptor *receiver) {
+  blockedSince[sender->tid & TASK_INDEX_MASK] = tickPageNow();
+  int &d = ++depth(receiver);
+  int &peak = queuePeak[receiver->tid & TASK_INDEX_MASK];
+  if (d > peak) {
+    peak = d;
+  }
+}
+
+void msgProfileDelivered(TaskDescriptor *sender, TaskDescriptor *receiver,
+                         int len, bool queued) {
+  unsigned int t = tickPageNow();
+  unsigned int &since = blockedSince[sender->tid & TASK_INDEX_MASK];
+  MsgFlowPair *pair = findPair(sender->tid, receiver->tid);
+  if (queued) {
+    int &d = depth(receiver);
+    if (d > 0) {
+      --d;
+    }
+    if (pair) {
+      pair->sendBlocked += t - since;
+    }
+  }
+  if (pair) {
+    ++pair->count;
+    pair->bytes += len;
+  }
+  // reply-blocked from here on
+  since = t;
+}
+
+void msgProfileReplied(TaskDescriptor *sender, TaskDescriptor *replier,
+                       int len) {
+  MsgFlowPair *pair = findPair(sender->tid, replier->tid);
+  if (pair) {
+    pair->replyBlocked +=
+        tickPageNow() - blockedSince[sender->tid & TASK_INDEX_MASK];
+    pair->bytes += len;
+  }
+}
+
+void handleMsgFlowRead() {
+  int index = curTask->tf.r0;
+  MsgFlow *flow = (MsgFlow *)curTask->tf.r1;
+  if (index < 0 || index >= MSG_FLOW_PAIRS) {
+    curTask->tf.r0 = -2;
+  } else if (!used[index]) {
+    curTask->tf.r0 = -1;
+  } else {
+    const MsgFlowPair &pair = pairs[index];
+    flow->sender = pair.sender;
+    flow->receiver = pair.receiver;
+    flow->count = pair.count;
+    flow->bytes = pair.bytes;
+    flow->sendBlocked = pair.sendBlocked;
+    flow->replyBlocked = pair.replyBlocked;
+    curTask->tf.r0 = 0;
+  }
+  taskYield();
+}
+
+void handleMsgQueueRead() {
+  int index = curTask->tf.r0;
+  MsgQueuePeak *peak = (MsgQueuePeak *)curTask->tf.r1;
+  if (index < 0 || index >= NUM_TASKS) {
+    curTask->tf.r0 = -2;
+  } else if (queueOwner[index] == -1 || queuePeak[index] == 0) {
+    curTask->tf.r0 = -1;
+  } else {
+    peak->tid = queueOwner[index];
+    peak->peak = queuePeak[index];
+    curTask->tf.r0 = 0;
+  }
+  taskYield();
+}
+
+void handleMsgFlowReset() {
+  for (int i = 0; i < MSG_FLOW_PAIRS; ++i) {
+    used[i] = false;
+  }
+  for (int i = 0; i < NUM_TASKS; ++i) {
+    // keep the current depth so queued senders are still accounted for
+    queuePeak[i] = queueDepth[i];
+  }
+  curTask->tf.r0 = 0;
+  taskYield();
+}
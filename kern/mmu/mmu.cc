@@ -0,0 +1,128 @@
+#include "kern/mmu.h"
+
+#include "kern/common.h"
+#include "kern/kmem.h"
+#include "kern/tick_page.h"
+
+// first-level section descriptor
+#define SECTION_TYPE 0b10
+#define SECTION_B (1 << 2)  // bufferable
+#define SECTION_C (1 << 3)  // cacheable
+#define SECTION_BIT4 (1 << 4)  // must be set on the ARM920T
+#define SECTION_AP_SHIFT 10
+#define AP_USER_READ 0b10
+#define AP_FULL 0b11
+
+#define DOMAIN_CLIENT 0b01  // accesses are checked against AP bits
+
+// CP15 c1 control bits
+#define CTRL_M (1 << 0)   // MMU
+#define CTRL_C (1 << 2)   // D-cache
+#define CTRL_W (1 << 3)   // write buffer, always on for the ARM920T
+#define CTRL_I (1 << 12)  // I-cache
+
+// ARM920T D-cache and I-cache: 8 segments of 64 lines of 32 bytes; one way
+// across all segments covers 256 contiguous bytes
+#define DCACHE_SEGMENTS 8
+#define DCACHE_INDICES 64
+#define CACHE_LINE 32
+#define CACHE_WAY_SPAN (CACHE_LINE * DCACHE_SEGMENTS)
+#define LOCKDOWN_SHIFT 26  // victim and lockdown base in CP15 c9
+
+namespace {
+
+unsigned int pageTable[NUM_SECTIONS] __attribute__((aligned(L1_TABLE_ALIGN)));
+
+unsigned int savedControl;
+unsigned int savedTtb;
+unsigned int savedDomains;
+
+unsigned int section(addr_t base, unsigned int ap, unsigned int attrs) {
+  return (base & ~((1 << SECTION_SHIFT) - 1)) | ap << SECTION_AP_SHIFT |
+         attrs | SECTION_BIT4 | SECTION_TYPE;
+}
+
+void cleanInvalidateDCache() {
+  for (unsigned int seg = 0; seg < DCACHE_SEGMENTS; ++seg) {
+    for (unsigned int index = 0; index < DCACHE_INDICES; ++index) {
+      unsigned int entry = index << 26 | seg << 5;
+      asm volatile("mcr p15, 0, %0, c7, c14, 2" : : "r"(entry));
+    }
+  }
+}
+
+void flushCaches() {
+  cleanInvalidateDCache();
+  asm volatile("mcr p15, 0, %0, c7, c5, 0" : : "r"(0));   // invalidate I-cache
+  asm volatile("mcr p15, 0, %0, c7, c10, 4" : : "r"(0));  // drain write buffer
+  asm volatile("mcr p15, 0, %0, c8, c7, 0" : : "r"(0));   // invalidate TLBs
+}
+
+}  // namespace
+
+KERN_INIT void mmuBootstrap() {
+  asm volatile("mrc p15, 0, %0, c1, c0, 0" : "=r"(savedControl));
+  asm volatile("mrc p15, 0, %0, c2, c0, 0" : "=r"(savedTtb));
+  asm volatile("mrc p15, 0, %0, c3, c0, 0" : "=r"(savedDomains));
+
+  for (unsigned int i = 0; i < NUM_SECTIONS; ++i) {
+    pageTable[i] = 0;  // translation fault
+  }
+  for (addr_t addr = 0; addr < SDRAM_SIZE; addr += 1 << SECTION_SHIFT) {
+    pageTable[addr >> SECTION_SHIFT] =
+        section(addr, AP_FULL, SECTION_C | SECTION_B);
+  }
+  // tasks may read the tick page but only the kernel publishes to it
+  pageTable[TICK_PAGE_ADDR >> SECTION_SHIFT] =
+      section(TICK_PAGE_ADDR, AP_USER_READ, SECTION_C | SECTION_B);
+  for (addr_t addr = DEVICE_START; addr < DEVICE_END;
+       addr += 1 << SECTION_SHIFT) {
+    // strongly ordered: neither cached nor buffered
+    pageTable[addr >> SECTION_SHIFT] = section(addr, AP_FULL, 0);
+  }
+
+  flushCaches();
+  asm volatile("mcr p15, 0, %0, c2, c0, 0" : : "r"(pageTable));
+  asm volatile("mcr p15, 0, %0, c3, c0, 0" : : "r"(DOMAIN_CLIENT));
+
+  unsigned int control = savedControl | CTRL_M | CTRL_C | CTRL_W | CTRL_I;
+  asm volatile("mcr p15, 0, %0, c1, c0, 0" : : "r"(control));
+  // the identity mapping keeps the next instruction fetch valid
+  asm volatile("nop; nop; nop");
+}
+
+KERN_INIT void icacheLockdown() {
+  addr_t start = (addr_t)&__kern_hot_start & ~(CACHE_WAY_SPAN - 1);
+  addr_t end = (addr_t)&__kern_hot_end;
+  unsigned int way = 0;
+  asm volatile("mcr p15, 0, %0, c7, c5, 0" : : "r"(0));  // invalidate I-cache
+  asm volatile("mcr p15, 0, %0, c9, c0, 1" : : "r"(way << LOCKDOWN_SHIFT));
+  for (addr_t addr = start; addr < end && way < ICACHE_MAX_LOCKED_WAYS;
+       addr += CACHE_LINE) {
+    // prefetch the line into the way the victim pointer selects
+    asm volatile("mcr p15, 0, %0, c7, c13, 1" : : "r"(addr));
+    if ((addr + CACHE_LINE) % CACHE_WAY_SPAN == 0) {
+      // every segment got a line, move on to the next way
+      ++way;
+      asm volatile("mcr p15, 0, %0, c9, c0, 1" : : "r"(way << LOCKDOWN_SHIFT));
+    }
+  }
+  if (end % CACHE_WAY_SPAN != 0 && way < ICACHE_MAX_LOCKED_WAYS) {
+    ++way;  // the last way is partially filled
+  }
+  // ways below the lockdown base are never chosen as victims
+  asm volatile("mcr p15, 0, %0, c9, c0, 1" : : "r"(way << LOCKDOWN_SHIFT));
+}
+
+KERN_INIT void mmuExit() {
+  // unlock the I-cache
+  asm volatile("mcr p15, 0, %0, c9, c0, 1" : : "r"(0));
+  cleanInvalidateDCache();
+  asm volatile("mcr p15, 0, %0, c7, c10, 4" : : "r"(0));  // drain write buffer
+  asm volatile("mcr p15, 0, %0, c1, c0, 0" : : "r"(savedControl));
+  asm volatile("mcr p15, 0, %0, c2, c0, 0" : : "r"(savedTtb));
+  asm volatile("mcr p15, 0, %0, c3, c0, 0" : : "r"(savedDomains));
+  asm volatile("mcr p15, 0, %0, c7, c5, 0" : : "r"(0));  // invalidate I-cache
+  asm volatile("mcr p15, 0, %0, c8, c7, 0" : : "r"(0));  // invalidate TLBs
+  asm volatile("nop; nop; nop");
+}
@@ -0,0 +1,93 @@
+#include "kern/profile.h"
+
+#include "kern/arch.h"
+#include "kern/task.h"
+#include "lib/timer.h"
+#include "user/profile.h"
+
+namespace {
+
+ProfileBucket buckets[PROFILE_BUCKETS];
+int totalSamples;
+
+unsigned int hash(unsigned int pc, int tid) {
+  // pcs are word aligned; mix in the tid so tasks sharing code spread out
+  return ((pc >> 2) ^ (unsigned int)tid * 2654435761u) & (PROFILE_BUCKETS - 1);
+}
+
+void record(unsigned int pc, int tid) {
+  ++totalSamples;
+  unsigned int index = hash(pc, tid);
+  for (int i = 0; i < PROFILE_MAX_PROBES; ++i) {
+    ProfileBucket &bucket = buckets[index];
+    if (bucket.count == 0) {
+      bucket.pc = pc;
+      bucket.tid = tid;
+    }
+    if (bucket.pc == pc && bucket.tid == tid) {
+      ++bucket.count;
+      return;
+    }
+    index = (index + 1) & (PROFILE_BUCKETS - 1);
+  }
+  // table too crowded around this key; the sample only counts in the total
+}
+
+void enableTimer1Interrupt(bool enable) {
+  unsigned int offset = enable ? INT_ENABLE_OFFSET : INT_ENABLE_CLEAR_OFFSET;
+  *(volatile unsigned int *)(TIMER1_VIC_BASE + offset) = TIMER1_VIC_MASK;
+}
+
+}  // namespace
+
+KERN_INIT void profileBootstrap() {
+  for (int i = 0; i < PROFILE_BUCKETS; ++i) {
+    buckets[i] = ProfileBucket{0, -1, 0};
+  }
+  totalSamples = 0;
+  timer::stop(TIMER1_BASE);
+  enableTimer1Interrupt(false);
+}
+
+void handleTC1UI() {
+  // clear tc1 interrupt
+  *(volatile unsigned int *)(TIMER1_BASE + CLR_OFFSET) = 1;
+  // trap() stored the interrupted pc in lrSVC
+  record(curTask->tf.lrSVC, curTask->tid);
+}
+
+void handleProfileControl() {
+  int hz = curTask->tf.r0;
+  if (hz != 0 && (hz < PROFILE_MIN_HZ || hz > PROFILE_MAX_HZ)) {
+    curTask->tf.r0 = -1;
+    taskYield();
+    return;
+  }
+  timer::stop(TIMER1_BASE);
+  curTask->tf.r0 = totalSamples;
+  if (hz > 0) {
+    profileBootstrap();
+    *(volatile unsigned int *)(TIMER1_BASE + LDR_OFFSET) = TIMER3_FRQ / hz;
+    timer::start(TIMER1_BASE);
+    enableTimer1Interrupt(true);
+  } else {
+    enableTimer1Interrupt(false);
+  }
+  taskYield();
+}
+
+void handleProfileRead() {
+  int index = curTask->tf.r0;
+  ProfileSample *sample = (ProfileSample *)curTask->tf.r1;
+  if (index < 0 || index >= PROFILE_BUCKETS) {
+    curTask->tf.r0 = -2;
+  } else if (buckets[index].count == 0) {
+    curTask->tf.r0 = -1;
+  } else {
+    sample->pc = buckets[index].pc;
+    sample->tid = buckets[index].tid;
+    sample->count = buckets[index].count;
+    curTask->tf.r0 = 0;
+  }
+  taskYield();
+}
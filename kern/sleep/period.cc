@@ -0,0 +1,119 @@
+#include "kern/period.h"
+
+#include "kern/common.h"
+#include "kern/sleep.h"
+#include "kern/task.h"
+#include "kern/tick_page.h"
+#include "user/sleep.h"
+#include "user/task.h"
+
+namespace {
+
+// per descriptor index
+PeriodInfo periods[NUM_TASKS];
+
+}  // namespace
+
+KERN_INIT void periodBootstrap() {
+  for (int i = 0; i < NUM_TASKS; ++i) {
+    periods[i].tid = -1;
+  }
+}
+
+void handleSetPeriod() {
+  int period = curTask->tf.r0;
+  int deadline = curTask->tf.r1;
+  if (period < 0 || deadline <= 0 || (period > 0 && deadline > period)) {
+    curTask->tf.r0 = -1;
+    taskYield();
+    return;
+  }
+  PeriodInfo &info = periods[curTask->tid & TASK_INDEX_MASK];
+  info.tid = curTask->tid;
+  info.period = period;
+  info.deadline = deadline;
+  info.releaseTick = timerWheel.now();
+  info.releaseTime = tickPageNow();
+  info.jobs = 0;
+  info.misses = 0;
+  info.overruns = 0;
+  info.worstResponse = 0;
+  curTask->deadline = info.releaseTick + deadline;
+  curTask->tf.r0 = 0;
+  taskYield();
+}
+
+void handleWaitNextPeriod() {
+  PeriodInfo &info = periods[curTask->tid & TASK_INDEX_MASK];
+  if (info.tid != curTask->tid) {
+    curTask->tf.r0 = -1;
+    taskYield();
+    return;
+  }
+
+  unsigned int response = tickPageNow() - info.releaseTime;
+  ++info.jobs;
+  if (response > info.worstResponse) {
+    info.worstResponse = response;
+  }
+  if (response > (unsigned int)info.deadline * TICK_TIMER_LOAD) {
+    ++info.misses;
+  }
+
+  int now = timerWheel.now();
+  if (info.period == 0) {
+    info.releaseTick = now;
+    info.releaseTime = tickPageNow();
+    curTask->deadline = now + info.deadline;
+    curTask->tf.r0 = now;
+    taskYield();
+    return;
+  }
+
+  // keep the phase: a job that ran past its successor's release loses it
+  int next = info.releaseTick + info.period;
+  while (next <= now) {
+    next += info.period;
+    ++info.overruns;
+  }
+  info.releaseTick = next;
+  info.releaseTime = (unsigned int)next * TICK_TIMER_LOAD;
+  curTask->deadline = next + info.deadline;
+  sleepCurTask(next);
+}
+
+void handleSetSchedClass() {
+  int schedClass = curTask->tf.r0;
+  if (schedClass != SCHED_FIXED && schedClass != SCHED_EDF) {
+    curTask->tf.r0 = -2;
+  } else if (schedClass == SCHED_EDF &&
+             periods[curTask->tid & TASK_INDEX_MASK].tid != curTask->tid) {
+    // without a period there is no deadline to order by
+    curTask->tf.r0 = -1;
+  } else {
+    curTask->edf = schedClass == SCHED_EDF;
+    curTask->tf.r0 = 0;
+  }
+  taskYield();
+}
+
+void handlePeriodStats() {
+  int index = curTask->tf.r0;
+  PeriodStats *stats = (PeriodStats *)curTask->tf.r1;
+  if (index < 0 || index >= NUM_TASKS) {
+    curTask->tf.r0 = -2;
+  } else if (!isTidValid(periods[index].tid)) {
+    curTask->tf.r0 = -1;
+  } else {
+    const PeriodInfo &info = periods[index];
+    stats->tid = info.tid;
+    stats->period = info.period;
+    stats->deadline = info.deadline;
+    stats->jobs = info.jobs;
+    stats->misses = info.misses;
+    stats->overruns = info.overruns;
+    stats->worstResponse = info.worstResponse;
+    curTask->tf.r0 = 0;
+  }
+  taskYield();
+}
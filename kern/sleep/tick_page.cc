@@ -0,0 +1,48 @@
+#include "kern/tick_page.h"
+
+#include "kern/common.h"
+#include "lib/timer.h"
+
+KERN_INIT void tickPageBootstrap() {
+  TICK_PAGE->seq = 0;
+  TICK_PAGE->tick = 0;
+  TICK_PAGE->tickTimer = TICK_TIMER_LOAD;
+  TICK_PAGE->offset = 0;
+  TICK_PAGE->load = TICK_TIMER_LOAD;
+}
+
+void tickPagePublish(int tick) {
+  TICK_PAGE->tickTimer = timer::getTick(TIMER3_BASE);
+  TICK_PAGE->tick = tick;
+  ++TICK_PAGE->seq;
+}
+
+void tickPageAdvance(int tick) {
+  TICK_PAGE->offset -=
+      (int)((unsigned int)(tick - TICK_PAGE->tick) * TICK_TIMER_LOAD);
+  TICK_PAGE->tick = tick;
+  ++TICK_PAGE->seq;
+}
+
+void tickPageRebase(int tick, int offset, unsigned int load) {
+  TICK_PAGE->tickTimer = 0xffffffff;
+  TICK_PAGE->tick = tick;
+  TICK_PAGE->offset = offset;
+  TICK_PAGE->load = load;
+  ++TICK_PAGE->seq;
+}
+
+void tickPageTime(int &tick, unsigned int &subTick) {
+  // no seq check needed, the kernel is the only writer
+  tick = TICK_PAGE->tick;
+  tickPageResolve(tick, subTick, TICK_PAGE->offset, TICK_PAGE->load,
+                  TICK_PAGE->tickTimer, timer::getTick(TIMER3_BASE));
+}
+
+unsigned int tickPageNow() {
+  int tick;
+  unsigned int subTick;
+  tickPageTime(tick, subTick);
+  // unsigned, so that it wraps instead of overflowing after 2^31 counts
+  return (unsigned int)tick * TICK_TIMER_LOAD + subTick;
+}
@@ -0,0 +1,138 @@
+#include "kern/tickless.h"
+
+#include "kern/budget.h"
+#include "kern/event.h"
+#include "kern/interrupt.h"
+#include "kern/sleep.h"
+#include "kern/syscall_code.h"
+#include "kern/task.h"
+#include "kern/tick_page.h"
+#include "lib/timer.h"
+
+namespace {
+
+struct Deadline {
+  int tick;
+  unsigned int subTick;
+};
+
+// the deadline TIMER3 is loaded for, if armed
+bool armed;
+Deadline armedAt;
+// earliest deadline requested since TIMER3 was last loaded
+bool requested;
+Deadline requestedAt;
+
+bool before(const Deadline &a, const Deadline &b) {
+  // the difference handles tick wrap-around
+  return a.tick - b.tick < 0 || (a.tick == b.tick && a.subTick < b.subTick);
+}
+
+void lower(Deadline &d, const Deadline &candidate) {
+  if (before(candidate, d)) {
+    d = candidate;
+  }
+}
+
+// every deadline the kernel knows of, at most TICKLESS_MAX_TICKS ahead
+Deadline earliest(int tick) {
+  Deadline d{timerWheel.nextExpiry(), 0};
+  int fine = timerWheel.nextFine();
+  if (fine >= 0) {
+    lower(d, {timerWheel.now(), (unsigned int)fine});
+  }
+  if (!eventBuffers[IRQ_TC3UI].isEmpty()) {
+    lower(d, {tick + 1, 0});
+  }
+  int replenish = budgetNextReplenish();
+  if (replenish >= 0) {
+    lower(d, {replenish, 0});
+  }
+  return d;
+}
+
+void load(const Deadline &d, int tick, unsigned int subTick) {
+  int ticks = d.tick - tick;
+  int counts;
+  if (ticks > TICKLESS_MAX_TICKS) {
+    counts = TICKLESS_MAX_TICKS * TICK_TIMER_LOAD;
+  } else {
+    counts = (int)((unsigned int)ticks * TICK_TIMER_LOAD + d.subTick - subTick);
+  }
+  // the time again right before the reload, so that the counts spent since
+  // tick and subTick were read are not lost with the old load
+  int nowTick;
+  unsigned int nowSubTick;
+  tickPageTime(nowTick, nowSubTick);
+  int late = (int)((unsigned int)(nowTick - tick) * TICK_TIMER_LOAD +
+                   nowSubTick - subTick);
+  counts -= late;
+  if (counts < TICKLESS_MIN_COUNTS) {
+    counts = TICKLESS_MIN_COUNTS;
+  }
+  timer::startFreeRunning(TIMER3_BASE, counts);
+  // the tick stays as the timer wheel has it; ticklessSync() catches up if
+  // late crossed into the next one
+  tickPageRebase(tick, subTick + late, counts);
+}
+
+}  // namespace
+
+KERN_INIT void ticklessBootstrap() {
+  requested = false;
+  armed = true;
+  armedAt = {1, 0};
+  timer::startFreeRunning(TIMER3_BASE, TICK_TIMER_LOAD);
+  tickPageRebase(0, 0, TICK_TIMER_LOAD);
+}
+
+KERN_HOT void ticklessSync() {
+  int tick;
+  unsigned int subTick;
+  tickPageTime(tick, subTick);
+  if (tick != timerWheel.now()) {
+    while (timerWheel.now() - tick < 0) {
+      timerWheel.advance();
+    }
+    tickPageAdvance(tick);
+    handleTick(tick);
+  }
+  timerWheel.expireFine(subTick);
+}
+
+void ticklessExpired() { armed = false; }
+
+void ticklessRequest(int tick, unsigned int subTick) {
+  Deadline d{tick, subTick};
+  if (!requested || before(d, requestedAt)) {
+    requested = true;
+    requestedAt = d;
+  }
+}
+
+KERN_HOT void ticklessArm() {
+  int tick;
+  unsigned int subTick;
+  tickPageTime(tick, subTick);
+
+  Deadline d = requested ? requestedAt : Deadline{tick + TICKLESS_MAX_TICKS, 0};
+  if (!armed) {
+    lower(d, earliest(tick));
+  }
+  // tasks sharing curTask's priority take turns every tick
+  if (!readyQueues.isEmpty(curTask->priority)) {
+    lower(d, {tick + 1, 0});
+  }
+  int budget = budgetRemaining(curTask);
+  if (budget >= 0) {
+    unsigned int end = subTick + budget;
+    lower(d, {tick + (int)(end / TICK_TIMER_LOAD), end % TICK_TIMER_LOAD});
+  }
+
+  requested = false;
+  if (!armed || before(d, armedAt)) {
+    load(d, tick, subTick);
+    armed = true;
+    armedAt = d;
+  }
+}
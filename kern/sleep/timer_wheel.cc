@@ -0,0 +1,200 @@
+#include "kern/arch.h"
+#include "kern/sleep.h"
+#include "kern/task.h"
+#include "kern/tick_page.h"
+#include "kern/tickless.h"
+#include "lib/assert.h"
+#include "lib/timer.h"
+
+TimerWheel timerWheel;
+
+TimerWheel::TimerWheel() : tick{0}, fine{nullptr} {
+  for (int level = 0; level < WHEEL_LEVELS; ++level) {
+    for (int i = 0; i < WHEEL_SLOTS; ++i) {
+      slots[level][i] = nullptr;
+    }
+  }
+}
+
+int TimerWheel::now() const { return tick; }
+
+void TimerWheel::insert(TaskDescriptor *task) {
+  int delta = task->wakeTick - tick;
+  kAssert(delta >= 0);
+
+  // wake-ups beyond the top level wait in its last slot and are refiled
+  // when that slot is cascaded
+  int until = task->wakeTick;
+  if (delta >= 1 << (WHEEL_BITS * WHEEL_LEVELS)) {
+    until = tick + (1 << (WHEEL_BITS * WHEEL_LEVELS)) - 1;
+    delta = until - tick;
+  }
+
+  int level = 0;
+  while (level < WHEEL_LEVELS - 1 && delta >= 1 << (WHEEL_BITS * (level + 1))) {
+    ++level;
+  }
+  int slot = (until >> (WHEEL_BITS * level)) & WHEEL_MASK;
+  task->nextEventBlocked = slots[level][slot];
+  slots[level][slot] = task;
+}
+
+void TimerWheel::insertFine(TaskDescriptor *task) {
+  TaskDescriptor **link = &fine;
+  while (*link && (*link)->wakeSubTick <= task->wakeSubTick) {
+    link = &(*link)->nextEventBlocked;
+  }
+  task->nextEventBlocked = *link;
+  *link = task;
+}
+
+void TimerWheel::cascade(int level) {
+  int slot = (tick >> (WHEEL_BITS * level)) & WHEEL_MASK;
+  TaskDescriptor *task = slots[level][slot];
+  slots[level][slot] = nullptr;
+  while (task) {
+    TaskDescriptor *next = task->nextEventBlocked;
+    insert(task);
+    task = next;
+  }
+}
+
+void TimerWheel::wake(TaskDescriptor *task) {
+  kAssert(task->state == TaskDescriptor::State::kSleepBlocked);
+  task->tf.r0 = tick;
+  task->state = TaskDescriptor::State::kReady;
+  readyQueues.enqueue(task);
+}
+
+void TimerWheel::advance() {
+  ++tick;
+
+  // whatever was due within the previous tick is late by now
+  while (fine) {
+    TaskDescriptor *next = fine->nextEventBlocked;
+    wake(fine);
+    fine = next;
+  }
+
+  // refile the higher-level slots that start at this tick, top-down so that
+  // tasks can fall through several levels at once
+  int level = 1;
+  while (level < WHEEL_LEVELS &&
+         (tick & ((1 << (WHEEL_BITS * level)) - 1)) == 0) {
+    ++level;
+  }
+  for (--level; level > 0; --level) {
+    cascade(level);
+  }
+
+  TaskDescriptor *task = slots[0][tick & WHEEL_MASK];
+  slots[0][tick & WHEEL_MASK] = nullptr;
+  while (task) {
+    TaskDescriptor *next = task->nextEventBlocked;
+    kAssert(task->wakeTick == tick);
+    if (task->wakeSubTick) {
+      insertFine(task);
+    } else {
+      wake(task);
+    }
+    task = next;
+  }
+}
+
+void TimerWheel::expireFine(unsigned int subTick) {
+  while (fine && fine->wakeSubTick <= subTick) {
+    TaskDescriptor *next = fine->nextEventBlocked;
+    wake(fine);
+    fine = next;
+  }
+}
+
+int TimerWheel::nextExpiry() const {
+  // slots from the next level-1 boundary on are only filled by its cascade
+  int boundary = (tick | WHEEL_MASK) + 1;
+  for (int t = tick + 1; t < boundary; ++t) {
+    if (slots[0][t & WHEEL_MASK]) {
+      return t;
+    }
+  }
+  return boundary;
+}
+
+int TimerWheel::nextFine() const { return fine ? fine->wakeSubTick : -1; }
+
+KERN_INIT void sleepBootstrap() {
+  timerWheel = TimerWheel();
+  tickPageBootstrap();
+
+#if ENABLE_TICKLESS
+  ticklessBootstrap();
+#else
+  // the kernel owns the 10 ms tick
+  timer::stop(TIMER3_BASE);
+  timer::load(TIMER3_BASE, TICK_MS);
+  timer::start(TIMER3_BASE);
+#endif
+}
+
+void sleepCurTask(int tick, unsigned int subTick) {
+  int now = timerWheel.now();
+  if (tick < now || (tick == now && subTick == 0)) {
+    curTask->tf.r0 = now;
+    taskYield();
+    return;
+  }
+  curTask->wakeTick = tick;
+  curTask->wakeSubTick = subTick;
+  curTask->state = TaskDescriptor::State::kSleepBlocked;
+  if (tick == now) {
+    timerWheel.insertFine(curTask);
+  } else {
+    timerWheel.insert(curTask);
+  }
+#if ENABLE_TICKLESS
+  ticklessRequest(tick, subTick);
+#endif
+}
+
+void handleSleep() {
+  int ticks = curTask->tf.r0;
+  if (ticks < 0) {
+    curTask->tf.r0 = -2;
+    taskYield();
+    return;
+  }
+  sleepCurTask(timerWheel.now() + ticks);
+}
+
+void handleSleepUntil() {
+  int tick = curTask->tf.r0;
+  if (tick < 0) {
+    curTask->tf.r0 = -2;
+    taskYield();
+    return;
+  }
+  sleepCurTask(tick);
+}
+
+void handleSleepUs() {
+  int us = curTask->tf.r0;
+  if (us < 0) {
+    curTask->tf.r0 = -2;
+    taskYield();
+    return;
+  }
+  int tick;
+  unsigned int subTick;
+  tickPageTime(tick, subTick);
+  subTick += us / 1000 * (TIMER3_FRQ / 1000) +
+             us % 1000 * (TIMER3_FRQ / 1000) / 1000;
+  tick += subTick / TICK_TIMER_LOAD;
+  subTick %= TICK_TIMER_LOAD;
+#if ENABLE_TICKLESS
+  sleepCurTask(tick, subTick);
+#else
+  // without tickless mode tasks only wake on a tick; round up so that the
+  // sleep is never shorter than asked
+  sleepCurTask(subTick ? tick + 1 : tick);
+#endif
+}
@@ -1,49 +1,48 @@
 #include "kern/syscall.h"
 
-#include "kern/arch/ts7200.h"
+#include "kern/arch.h"
+#include "kern/budget.h"
 #include "kern/event.h"
 #include "kern/interrupt.h"
 #include "kern/message.h"
+#include "kern/msg_profile.h"
+#include "kern/period.h"
+#include "kern/profile.h"
+#include "kern/sleep.h"
+#include "kern/stack.h"
 #include "kern/sys.h"
 #include "kern/task.h"
+#include "kern/tick_page.h"
+#include "kern/tickless.h"
+#include "kern/uart.h"
 #include "lib/assert.h"
 #include "lib/bwio.h"
-#include "lib/math.h"
 #include "lib/timer.h"
 
 #define TIMER2_INIT_MS 100
 
 extern "C" {
-void trap(Trapframe *tf) {
+KERN_HOT void trap(Trapframe *tf) {
   if (curTask->priority == 7 && curTask->nextReady == nullptr) {
-    int temp = 508 * TIMER2_INIT_MS - timer::getTick(TIMER2_BASE);
+    int temp =
+        TIMER3_FRQ / 1000 * TIMER2_INIT_MS - timer::getTick(TIMER2_BASE);
     idleTime += temp;
   }
   curTask->tf = *tf;
+  budgetCharge();
 }
 
-unsigned int getIrqStatus() {
-  unsigned int vic1Status =
-      *(volatile unsigned int *)(VIC1_BASE + IRQ_STATUS_OFFSET);
-  unsigned int vic2Status =
-      *(volatile unsigned int *)(VIC2_BASE + IRQ_STATUS_OFFSET);
-  kAssert(vic1Status != 0 || vic2Status != 0);
-
-  unsigned int result = -1;
-  if (vic1Status != 0) {
-    result = log2(vic1Status);
-  } else {
-    result = log2(vic2Status) + 32;
-  }
-  kAssert(0 <= result && result < 64);
-  // bwprintf(COM2, "irq: %d\n\r", result);
-  return result;
-}
-
-void enterKernel(unsigned int code) {
+KERN_HOT void enterKernel(unsigned int code) {
   code &= 0xffffff;
+#if ENABLE_TICKLESS
+  ticklessSync();
+#endif
 
   switch (code) {
+    case IRQ_TC1UI:
+      handleTC1UI();
+      taskYield();
+      break;
     case IRQ_TC3UI:
       handleTC3UI();
       taskYield();
@@ -57,6 +56,10 @@ void enterKernel(unsigned int code) {
       taskCreate(&curTask->tf);
       taskYield();
       break;
+    case SYS_CREATE_ARGS:
+      taskCreateArgs(&curTask->tf);
+      taskYield();
+      break;
     case SYS_TID:
       curTask->tf.r0 = curTask->tid;
       taskYield();
@@ -91,7 +94,84 @@ void enterKernel(unsigned int code) {
       // kExit does not return, so this line should never be reached
       break;
     case SYS_IDLE_TIME:
-      curTask->tf.r0 = idleTime / 5080;
+      curTask->tf.r0 = idleTime / TICK_TIMER_LOAD;
+      taskYield();
+      break;
+    case SYS_UART_READ:
+      handleUartRead();
+      break;
+    case SYS_UART_WRITE:
+      handleUartWrite();
+      break;
+    case SYS_UART_FLUSH:
+      handleUartFlush();
+      break;
+    case SYS_SLEEP:
+      handleSleep();
+      break;
+    case SYS_SLEEP_UNTIL:
+      handleSleepUntil();
+      break;
+    case SYS_SLEEP_US:
+      handleSleepUs();
+      break;
+    case SYS_STACK_IN_USE:
+      curTask->tf.r0 = stackPool.getInUse();
+      taskYield();
+      break;
+    case SYS_STACK_PROFILE:
+      taskStackProfile(&curTask->tf);
+      taskYield();
+      break;
+    case SYS_TASK_ALIVE: {
+      // a task that called exit() keeps its tid until it is destroyed
+      TaskDescriptor *task = getTd((int)curTask->tf.r0);
+      curTask->tf.r0 = task && task->state != TaskDescriptor::State::kZombie;
+      taskYield();
+      break;
+    }
+    case SYS_PROFILE_CONTROL:
+      handleProfileControl();
+      break;
+    case SYS_PROFILE_READ:
+      handleProfileRead();
+      break;
+    case SYS_MSG_FLOW_READ:
+      handleMsgFlowRead();
+      break;
+    case SYS_MSG_QUEUE_READ:
+      handleMsgQueueRead();
+      break;
+    case SYS_MSG_FLOW_RESET:
+      handleMsgFlowReset();
+      break;
+    case SYS_SET_PERIOD:
+      handleSetPeriod();
+      break;
+    case SYS_WAIT_NEXT_PERIOD:
+      handleWaitNextPeriod();
+      break;
+    case SYS_PERIOD_STATS:
+      handlePeriodStats();
+      break;
+    case SYS_SET_BUDGET:
+      handleSetBudget();
+      break;
+    case SYS_BUDGET_STATS:
+      handleBudgetStats();
+      break;
+    case SYS_SET_SCHED_CLASS:
+      handleSetSchedClass();
+      break;
+    case SYS_SET_PRIORITY:
+      handleSetPriority();
+      break;
+    case SYS_SET_GATEWAY:
+      msgSetGateway();
+      taskYield();
+      break;
+    case SYS_REMOTE_TARGET:
+      msgRemoteTarget();
       taskYield();
       break;
     default:
@@ -105,11 +185,15 @@ void enterKernel(unsigned int code) {
 }
 }
 
-void leaveKernel() {
+KERN_HOT void leaveKernel() {
   if (curTask->priority == 7 && curTask->nextReady == nullptr) {
     timer::stop(TIMER2_BASE);
     timer::load(TIMER2_BASE, TIMER2_INIT_MS);
     timer::start(TIMER2_BASE);
   }
+  budgetStart();
+#if ENABLE_TICKLESS
+  ticklessArm();
+#endif
   userMode(&curTask->tf);
 }
\ No newline at end of file
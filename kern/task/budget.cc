@@ -0,0 +1,206 @@
+#include "kern/budget.h"
+
+#include "kern/common.h"
+#include "kern/task.h"
+#include "kern/tick_page.h"
+#include "user/task.h"
+
+namespace {
+
+Budget budgets[BUDGET_MAX_TASKS];
+// budget slot of each descriptor index, -1 if none
+signed char slotOf[NUM_TASKS];
+// when curTask of the core last left the kernel
+CORE_LOCAL unsigned int runStart;
+
+Budget *findBudget(TaskDescriptor *task) {
+  int slot = slotOf[task->tid & TASK_INDEX_MASK];
+  if (slot < 0 || budgets[slot].tid != task->tid) {
+    return nullptr;
+  }
+  return &budgets[slot];
+}
+
+void restore(Budget &b, TaskDescriptor *task, int tick) {
+  if (b.demoted) {
+    b.demoted = false;
+    b.throttledTicks += tick - b.demotedTick;
+    taskSetPriority(task, b.priority);
+  }
+}
+
+void release(int slot) {
+  slotOf[budgets[slot].tid & TASK_INDEX_MASK] = -1;
+  budgets[slot].tid = -1;
+}
+
+}  // namespace
+
+KERN_INIT void budgetBootstrap() {
+  for (int i = 0; i < BUDGET_MAX_TASKS; ++i) {
+    budgets[i].tid = -1;
+  }
+  for (int i = 0; i < NUM_TASKS; ++i) {
+    slotOf[i] = -1;
+  }
+}
+
+KERN_HOT void budgetCharge() {
+  Budget *b = findBudget(curTask);
+  if (!b) {
+    return;
+  }
+  b->remaining -= tickPageNow() - runStart;
+  if (b->remaining <= 0 && !b->demoted) {
+    // curTask is not on a ready queue while the kernel handles its trap
+    b->demoted = true;
+    b->demotedTick = TICK_PAGE->tick;
+    ++b->throttles;
+    if (b->priority < BUDGET_DEMOTED_PRIORITY) {
+      curTask->priority = BUDGET_DEMOTED_PRIORITY;
+    }
+  }
+}
+
+KERN_HOT void budgetStart() {
+  if (findBudget(curTask)) {
+    runStart = tickPageNow();
+  }
+}
+
+void budgetReplenish(int tick) {
+  for (int i = 0; i < BUDGET_MAX_TASKS; ++i) {
+    Budget &b = budgets[i];
+    // differences, so that the tick wrapping around does not stop or repeat
+    // replenishing
+    if (b.tid == -1 || b.nextReplenish - tick > 0) {
+      continue;
+    }
+    TaskDescriptor *task = getTd(b.tid);
+    if (!task) {
+      release(i);
+      continue;
+    }
+    // overspending is not carried into the next period
+    b.remaining = b.budget;
+    while (b.nextReplenish - tick <= 0) {
+      b.nextReplenish += b.period;
+    }
+    restore(b, task, tick);
+  }
+}
+
+int budgetRemaining(TaskDescriptor *task) {
+  Budget *b = findBudget(task);
+  if (!b || b->demoted) {
+    return -1;
+  }
+  return b->remaining > 0 ? b->remaining : 0;
+}
+
+int budgetNextReplenish() {
+  int next = -1;
+  for (int i = 0; i < BUDGET_MAX_TASKS; ++i) {
+    const Budget &b = budgets[i];
+    if (b.tid != -1 && b.demoted &&
+        (next == -1 || b.nextReplenish - next < 0)) {
+      next = b.nextReplenish;
+    }
+  }
+  return next;
+}
+
+int budgetOwnPriority(TaskDescriptor *task) {
+  Budget *b = findBudget(task);
+  return b ? b->priority : task->priority;
+}
+
+int budgetSetPriority(TaskDescriptor *task, int priority) {
+  Budget *b = findBudget(task);
+  if (!b) {
+    return priority;
+  }
+  b->priority = priority;
+  if (b->demoted && priority < BUDGET_DEMOTED_PRIORITY) {
+    return BUDGET_DEMOTED_PRIORITY;
+  }
+  return priority;
+}
+
+void handleSetBudget() {
+  int tid = curTask->tf.r0;
+  int budgetUs = curTask->tf.r1;
+  int period = curTask->tf.r2;
+  TaskDescriptor *task = getTd(tid);
+  if (!task || (task != curTask && task->parentTid != curTask->tid)) {
+    curTask->tf.r0 = -1;
+    taskYield();
+    return;
+  }
+  if (budgetUs < 0 || period <= 0 || budgetUs > period * TICK_MS * 1000) {
+    curTask->tf.r0 = -2;
+    taskYield();
+    return;
+  }
+
+  int tick = TICK_PAGE->tick;
+  Budget *b = findBudget(task);
+  if (budgetUs == 0) {
+    if (b) {
+      restore(*b, task, tick);
+      release(b - budgets);
+    }
+    curTask->tf.r0 = 0;
+    taskYield();
+    return;
+  }
+  if (!b) {
+    for (int i = 0; i < BUDGET_MAX_TASKS; ++i) {
+      if (budgets[i].tid == -1 || !isTidValid(budgets[i].tid)) {
+        if (budgets[i].tid != -1) {
+          release(i);
+        }
+        b = &budgets[i];
+        slotOf[tid & TASK_INDEX_MASK] = i;
+        *b = Budget{tid, task->priority, 0, 0, 0, 0, 0, false, 0, 0, 0};
+        break;
+      }
+    }
+    if (!b) {
+      curTask->tf.r0 = -3;
+      taskYield();
+      return;
+    }
+  }
+  restore(*b, task, tick);
+  b->budgetUs = budgetUs;
+  b->budget = budgetUs / 1000 * (TIMER3_FRQ / 1000) +
+              budgetUs % 1000 * (TIMER3_FRQ / 1000) / 1000;
+  b->period = period;
+  b->remaining = b->budget;
+  b->nextReplenish = tick + period;
+  curTask->tf.r0 = 0;
+  taskYield();
+}
+
+void handleBudgetStats() {
+  int index = curTask->tf.r0;
+  BudgetStats *stats = (BudgetStats *)curTask->tf.r1;
+  if (index < 0 || index >= BUDGET_MAX_TASKS) {
+    curTask->tf.r0 = -2;
+  } else if (!isTidValid(budgets[index].tid)) {
+    curTask->tf.r0 = -1;
+  } else {
+    const Budget &b = budgets[index];
+    stats->tid = b.tid;
+    stats->priority = b.priority;
+    stats->budget = b.budgetUs;
+    stats->period = b.period;
+    stats->throttles = b.throttles;
+    stats->throttledTicks =
+        b.throttledTicks + (b.demoted ? TICK_PAGE->tick - b.demotedTick : 0);
+    stats->demoted = b.demoted;
+    curTask->tf.r0 = 0;
+  }
+  taskYield();
+}
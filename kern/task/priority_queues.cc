@@ -8,9 +8,36 @@ PriorityQueues::PriorityQueues() {
   }
 }
 
-void PriorityQueues::enqueue(TaskDescriptor *task) {
+namespace {
+
+// whether a should run before b; a is an edf task
+bool earlier(TaskDescriptor *a, TaskDescriptor *b) {
+  // ties keep FIFO order; the difference handles tick wrap-around
+  return !b->edf || a->deadline - b->deadline < 0;
+}
+
+}  // namespace
+
+KERN_HOT void PriorityQueues::enqueue(TaskDescriptor *task) {
   int priority = task->priority;
   assert(0 <= priority && priority < NUM_PRIORITY_LEVELS);
+  if (task->edf && heads[priority] && earlier(task, tails[priority])) {
+    // edf tasks go before fixed-priority tasks of the same level, ordered by
+    // deadline; the tail check keeps the common case O(1)
+    TaskDescriptor *prev = nullptr;
+    TaskDescriptor *t = heads[priority];
+    while (!earlier(task, t)) {
+      prev = t;
+      t = t->nextReady;
+    }
+    task->nextReady = t;
+    if (prev) {
+      prev->nextReady = task;
+    } else {
+      heads[priority] = task;
+    }
+    return;
+  }
   if (!heads[priority]) {
     assert(!tails[priority]);
     heads[priority] = task;
@@ -22,7 +49,7 @@ void PriorityQueues::enqueue(TaskDescriptor *task) {
   task->nextReady = nullptr;
 }
 
-TaskDescriptor *PriorityQueues::dequeue(int priority) {
+KERN_HOT TaskDescriptor *PriorityQueues::dequeue(int priority) {
   assert(0 <= priority && priority < NUM_PRIORITY_LEVELS);
   TaskDescriptor *h = heads[priority];
   if (h) {
@@ -34,7 +61,7 @@ TaskDescriptor *PriorityQueues::dequeue(int priority) {
   return h;
 }
 
-TaskDescriptor *PriorityQueues::dequeue() {
+KERN_HOT TaskDescriptor *PriorityQueues::dequeue() {
   for (int i = 0; i < NUM_PRIORITY_LEVELS; ++i) {
     TaskDescriptor *h = dequeue(i);
     if (h) {
@@ -44,7 +71,29 @@ TaskDescriptor *PriorityQueues::dequeue() {
   return nullptr;
 }
 
+bool PriorityQueues::remove(TaskDescriptor *task) {
+  int priority = task->priority;
+  assert(0 <= priority && priority < NUM_PRIORITY_LEVELS);
+  TaskDescriptor *prev = nullptr;
+  for (TaskDescriptor *t = heads[priority]; t; prev = t, t = t->nextReady) {
+    if (t != task) {
+      continue;
+    }
+    if (prev) {
+      prev->nextReady = t->nextReady;
+    } else {
+      heads[priority] = t->nextReady;
+    }
+    if (tails[priority] == t) {
+      tails[priority] = prev;
+    }
+    t->nextReady = nullptr;
+    return true;
+  }
+  return false;
+}
+
 bool PriorityQueues::isEmpty(int priority) {
   assert(0 <= priority && priority < NUM_PRIORITY_LEVELS);
-  return heads[priority];
+  return !heads[priority];
 }
@@ -0,0 +1,88 @@
+#include "kern/stack.h"
+
+#include "lib/assert.h"
+#include "user/task.h"
+
+StackPool stackPool;
+
+StackPool::StackPool() : next{USER_STACK_START}, inUse{0} {
+  for (int i = 0; i < NUM_STACK_CLASSES; ++i) {
+    freeLists[i] = 0;
+  }
+}
+
+/**
+ * @brief allocate a stack of the given class
+ *
+ * @return the top of the stack, 0 if the stack region is used up
+ */
+addr_t StackPool::alloc(int stackClass) {
+  kAssert(isValid(stackClass));
+  int sz = size(stackClass);
+  addr_t top = 0;
+  if (freeLists[stackClass]) {
+    addr_t bottom = freeLists[stackClass];
+    freeLists[stackClass] = *(addr_t *)bottom;
+    top = bottom + sz;
+  } else if (next - (USER_STACK_START - USER_STACK_REGION) >= (addr_t)sz) {
+    top = next;
+    next -= sz;
+  } else {
+    return 0;
+  }
+  inUse += sz;
+  return top;
+}
+
+void StackPool::free(addr_t top, int stackClass) {
+  kAssert(isValid(stackClass));
+  int sz = size(stackClass);
+  addr_t bottom = top - sz;
+  *(addr_t *)bottom = freeLists[stackClass];
+  freeLists[stackClass] = bottom;
+  inUse -= sz;
+}
+
+int StackPool::getInUse() const { return inUse; }
+
+int StackPool::getCarved() const { return USER_STACK_START - next; }
+
+bool StackPool::isValid(int stackClass) {
+  return 0 <= stackClass && stackClass < NUM_STACK_CLASSES;
+}
+
+int StackPool::size(int stackClass) {
+  switch (stackClass) {
+    case STACK_SMALL:
+      return STACK_SMALL_SIZE;
+    case STACK_TINY:
+      return STACK_TINY_SIZE;
+    default:
+      return STACK_LARGE_SIZE;
+  }
+}
+
+/**
+ * @brief overwrite the whole stack with STACK_CANARY so that peakUsage() can
+ * later find the deepest word the task has written
+ */
+void StackPool::fillCanary(addr_t top, int stackClass) {
+  unsigned int *bottom = (unsigned int *)(top - size(stackClass));
+  unsigned int *end = (unsigned int *)top;
+  for (unsigned int *p = bottom; p < end; ++p) {
+    *p = STACK_CANARY;
+  }
+}
+
+/**
+ * @brief bytes between the stack top and the lowest word that no longer holds
+ * the canary
+ */
+int StackPool::peakUsage(addr_t top, int stackClass) {
+  unsigned int *p = (unsigned int *)(top - size(stackClass));
+  unsigned int *end = (unsigned int *)top;
+  while (p < end && *p == STACK_CANARY) {
+    ++p;
+  }
+  return top - (addr_t)(unsigned long)p;
+}
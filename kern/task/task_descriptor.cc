@@ -2,24 +2,42 @@
 #include "lib/assert.h"
 
 TaskDescriptor::TaskDescriptor(int parentTid, int priority, int tid)
-    : tid{tid},
-      parentTid{parentTid},
+    : nextReady{nullptr},
       priority{priority},
-      nextReady{nullptr},
-      sendQueue{},
       state{State::kReady},
-      retVal{0} {}
+      tid{tid},
+      sendHead{nullptr},
+      sendTail{nullptr},
+      nextSend{nullptr},
+      nextEventBlocked{nullptr},
+      parentTid{parentTid},
+      retVal{0},
+      wakeTick{0},
+      stackTop{0},
+      stackClass{0},
+      deadline{0},
+      edf{false} {}
 
 TaskDescriptor::TaskDescriptor() : TaskDescriptor{-1, -1, -1} {}
 
 void TaskDescriptor::enqueueSender(TaskDescriptor *sender) {
   kAssert(sender != nullptr);
-  sendQueue.enqueue(sender);
+  sender->nextSend = nullptr;
+  if (sendTail) {
+    sendTail->nextSend = sender;
+  } else {
+    sendHead = sender;
+  }
+  sendTail = sender;
 }
 
 TaskDescriptor *TaskDescriptor::dequeueSender() {
-  if (sendQueue.size() > 0) {
-    return sendQueue.dequeue();
+  TaskDescriptor *sender = sendHead;
+  if (sender) {
+    sendHead = sender->nextSend;
+    if (!sendHead) {
+      sendTail = nullptr;
+    }
   }
-  return nullptr;
+  return sender;
 }
@@ -1,25 +1,28 @@
+#include "kern/budget.h"
 #include "kern/common.h"
+#include "kern/stack.h"
 #include "kern/sys.h"
 #include "kern/task.h"
 #include "lib/bwio.h"
 #include "user/task.h"
 #include "lib/queue.h"
 
-#define USER_STACK_START 0x1000000
+#define MAX_ARGS_LEN 256
 
 TaskDescriptor tasks[NUM_TASKS];
-TaskDescriptor *curTask;
+CORE_LOCAL TaskDescriptor *curTask;
 
-PriorityQueues readyQueues;
-Queue<int, 64> tidPool;
+ReadyQueues readyQueues;
+Queue<int, NUM_TASKS> tidPool;
 
-void taskBootstrap() {
+KERN_INIT void taskBootstrap() {
   for (int i = 0; i < NUM_TASKS; ++i) {
     tasks[i] = TaskDescriptor{};
   }
   curTask = nullptr;
-  readyQueues = PriorityQueues();
-  tidPool = Queue<int, 64>{};
+  readyQueues = ReadyQueues();
+  stackPool = StackPool{};
+  tidPool = Queue<int, NUM_TASKS>{};
   for (int i = 0; i < NUM_TASKS; ++i) {
     bool enqueueDone = tidPool.enqueue(i);
     kAssert(enqueueDone);
@@ -31,47 +34,158 @@ void taskStart(void (*fn)()) {
   destroy();
 }
 
-void taskCreate(Trapframe *tf) {
-  int priority = tf->r0;
-  auto fn = tf->r1;
+void taskStartArgs(void (*fn)(const void *), const void *args) {
+  fn(args);
+  destroy();
+}
+
+TaskDescriptor *taskAlloc(Trapframe *tf, int priority, int stackClass) {
   if (priority < 0 || priority >= NUM_PRIORITY_LEVELS) {
     tf->r0 = -1;
-    return;
+    return nullptr;
   }
   if (tidPool.size() == 0) {
     tf->r0 = -2;
-    return;
+    return nullptr;
+  }
+  if (!StackPool::isValid(stackClass)) {
+    tf->r0 = -3;
+    return nullptr;
+  }
+  addr_t stack = stackPool.alloc(stackClass);
+  if (!stack) {
+    tf->r0 = -4;
+    return nullptr;
   }
 
   int tid = tidPool.dequeue();
-  int index = tid % NUM_TASKS;
-  addr_t stack = USER_STACK_START - index * USER_STACK_SIZE;
+  int index = tid & TASK_INDEX_MASK;
   TaskDescriptor &task = tasks[index];
   kAssert(!isTidValid(tid)); // tid must be invalid at this point
-  task = TaskDescriptor{curTask->tid, priority, tid};
-  task.tf.r0 = fn;
+  // the first task is created by kmain and has no parent
+  task = TaskDescriptor{curTask ? curTask->tid : -1, priority, tid};
+  task.stackTop = stack;
+  task.stackClass = stackClass;
+#if ENABLE_STACK_PROFILE
+  StackPool::fillCanary(stack, stackClass);
+#endif
   task.tf.r11 = stack;  // frame pointer
   task.tf.r13 = stack;  // stack pointer
-  task.tf.lrSVC = (unsigned int)taskStart;
   task.tf.spsr = 0b10000;
-  readyQueues.enqueue(&task);
   tf->r0 = task.tid;  // return tid in r0
+  return &task;
+}
+
+void taskCreate(Trapframe *tf) {
+  int priority = tf->r0;
+  auto fn = tf->r1;
+  int stackClass = tf->r2;
+  TaskDescriptor *task = taskAlloc(tf, priority, stackClass);
+  if (!task) {
+    return;
+  }
+  task->tf.r0 = fn;
+  task->tf.lrSVC = (unsigned int)(unsigned long)taskStart;
+  readyQueues.enqueue(task);
 }
 
-void taskYield() {
+void taskCreateArgs(Trapframe *tf) {
+  int priority = tf->r0;
+  auto fn = tf->r1;
+  const char *args = (const char *)tf->r2;
+  int argsLen = tf->r3;
+  int stackClass = *(int *)tf->r13;  // 5th argument is on the user stack
+  if (argsLen < 0 || argsLen > MAX_ARGS_LEN || (argsLen > 0 && !args)) {
+    tf->r0 = -3;
+    return;
+  }
+  TaskDescriptor *task = taskAlloc(tf, priority, stackClass);
+  if (!task) {
+    return;
+  }
+
+  // copy the arguments to the top of the new stack, keeping sp 8-byte aligned
+  addr_t stack = task->tf.r13 - ((argsLen + 7) & ~7);
+  char *dst = (char *)stack;
+  for (int i = 0; i < argsLen; ++i) {
+    dst[i] = args[i];
+  }
+  task->tf.r11 = stack;
+  task->tf.r13 = stack;
+  task->tf.r0 = fn;
+  task->tf.r1 = stack;
+  task->tf.lrSVC = (unsigned int)(unsigned long)taskStartArgs;
+  readyQueues.enqueue(task);
+}
+
+void taskStackProfile(Trapframe *tf) {
+  int index = tf->r0;
+  StackProfile *profile = (StackProfile *)tf->r1;
+  if (index < 0 || index >= NUM_TASKS) {
+    tf->r0 = -2;
+    return;
+  }
+  TaskDescriptor &task = tasks[index];
+  if (task.tid == -1 || task.stackTop == 0) {
+    tf->r0 = -1;
+    return;
+  }
+  profile->tid = task.tid;
+  profile->size = StackPool::size(task.stackClass);
+#if ENABLE_STACK_PROFILE
+  profile->peak = StackPool::peakUsage(task.stackTop, task.stackClass);
+#else
+  profile->peak = -1;
+#endif
+  tf->r0 = 0;
+}
+
+KERN_HOT void taskYield() {
   curTask->state = TaskDescriptor::State::kReady;
   readyQueues.enqueue(curTask);
 }
 
+void taskSetPriority(TaskDescriptor *task, int priority) {
+  if (task->priority == priority) {
+    return;
+  }
+  if (task->state == TaskDescriptor::State::kReady &&
+      readyQueues.remove(task)) {
+    task->priority = priority;
+    readyQueues.enqueue(task);
+  } else {
+    task->priority = priority;
+  }
+}
+
+void handleSetPriority() {
+  int tid = curTask->tf.r0;
+  int priority = curTask->tf.r1;
+  TaskDescriptor *task = getTd(tid);
+  if (priority < 0 || priority >= NUM_PRIORITY_LEVELS) {
+    curTask->tf.r0 = -1;
+  } else if (!task || (task != curTask && task->parentTid != curTask->tid)) {
+    curTask->tf.r0 = -2;
+  } else {
+    // a task throttled by its budget only gets the new priority back when
+    // the budget is refilled
+    curTask->tf.r0 = budgetOwnPriority(task);
+    taskSetPriority(task, budgetSetPriority(task, priority));
+  }
+  taskYield();
+}
+
 void taskExit() { curTask->state = TaskDescriptor::State::kZombie; }
 
 void taskDestroy() {
-  tidPool.enqueue(curTask->tid + NUM_TASKS);
+  stackPool.free(curTask->stackTop, curTask->stackClass);
+  // bump the generation; the index bits are unchanged when it wraps
+  tidPool.enqueue((curTask->tid + NUM_TASKS) & TID_MASK);
   curTask->tid = -1;
   curTask->state = TaskDescriptor::State::kZombie;
 }
 
-int taskActivate(TaskDescriptor *task) {
+KERN_HOT int taskActivate(TaskDescriptor *task) {
   curTask = task;
   task->state = TaskDescriptor::State::kActive;
   leaveKernel();
@@ -80,19 +194,19 @@ int taskActivate(TaskDescriptor *task) {
   return 0;
 }
 
-TaskDescriptor *taskSchedule() { return readyQueues.dequeue(); }
+KERN_HOT TaskDescriptor *taskSchedule() { return readyQueues.dequeue(); }
 
-TaskDescriptor *getTd(int tid) {
-  if (tid == -1) {
+KERN_HOT TaskDescriptor *getTd(int tid) {
+  if (tid < 0) {
     return nullptr;
   }
-  TaskDescriptor *td = &tasks[tid % NUM_TASKS];
+  TaskDescriptor *td = &tasks[tid & TASK_INDEX_MASK];
   if (td->tid == tid) {
     return td;
   }
   return nullptr;
 }
 
-bool isTidValid(int tid) {
+KERN_HOT bool isTidValid(int tid) {
   return getTd(tid) != nullptr;
 }
@@ -0,0 +1,188 @@
+#include "kern/uart.h"
+
+#include "kern/arch.h"
+#include "kern/task.h"
+#include "lib/assert.h"
+
+UartDriver uartDrivers[NUM_UARTS];
+
+namespace {
+
+void pushBlocked(TaskDescriptor *&head, TaskDescriptor *&tail,
+                 TaskDescriptor *task) {
+  task->nextEventBlocked = nullptr;
+  if (tail) {
+    tail->nextEventBlocked = task;
+  } else {
+    head = task;
+  }
+  tail = task;
+}
+
+TaskDescriptor *popBlocked(TaskDescriptor *&head, TaskDescriptor *&tail) {
+  TaskDescriptor *task = head;
+  if (task) {
+    head = task->nextEventBlocked;
+    if (!head) {
+      tail = nullptr;
+    }
+  }
+  return task;
+}
+
+void unblock(TaskDescriptor *task, int retVal) {
+  kAssert(task->state == TaskDescriptor::State::kIoBlocked);
+  task->tf.r0 = retVal;
+  task->state = TaskDescriptor::State::kReady;
+  readyQueues.enqueue(task);
+}
+
+UartDriver *getDriver(unsigned int channel) {
+  switch (channel) {
+    case COM1:
+      return &uartDrivers[0];
+    case COM2:
+      return &uartDrivers[1];
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+UartDriver::UartDriver()
+    : base{0},
+      cts{false},
+      ctsHigh{false},
+      ctsReady{false},
+      readersHead{nullptr},
+      readersTail{nullptr},
+      writersHead{nullptr},
+      writersTail{nullptr},
+      flushersHead{nullptr},
+      flushersTail{nullptr} {}
+
+int UartDriver::copyToTask(TaskDescriptor *task) {
+  char *buf = (char *)task->tf.r1;
+  int len = (int)task->tf.r2;
+  int copiedLen = 0;
+  while (copiedLen < len && recvBuffer.size() > 0) {
+    buf[copiedLen++] = recvBuffer.dequeue();
+  }
+  return copiedLen;
+}
+
+bool UartDriver::copyFromTask(TaskDescriptor *task) {
+  // r1 and r2 track the part of the user buffer not yet copied
+  const char *buf = (const char *)task->tf.r1;
+  int len = (int)task->tf.r2;
+  while (len > 0 && sendBuffer.enqueue(*buf)) {
+    ++buf;
+    --len;
+  }
+  task->tf.r1 = (unsigned int)(unsigned long)buf;
+  task->tf.r2 = len;
+  return len == 0;
+}
+
+void UartDriver::wakeReaders() {
+  while (readersHead && recvBuffer.size() > 0) {
+    TaskDescriptor *reader = popBlocked(readersHead, readersTail);
+    unblock(reader, copyToTask(reader));
+  }
+}
+
+void UartDriver::wakeWriters() {
+  while (writersHead && copyFromTask(writersHead)) {
+    TaskDescriptor *writer = popBlocked(writersHead, writersTail);
+    unblock(writer, writer->tf.r3);
+  }
+}
+
+// called by fillTx() whenever it has moved bytes to the transmitter
+void UartDriver::wakeFlushers() {
+  if (sendBuffer.size() > 0 || writersHead) {
+    return;
+  }
+  while (flushersHead) {
+    unblock(popBlocked(flushersHead, flushersTail), 0);
+  }
+}
+
+bool UartDriver::read(TaskDescriptor *task) {
+  if ((int)task->tf.r2 <= 0) {
+    task->tf.r0 = 0;
+    return true;
+  }
+  if (readersHead || recvBuffer.size() == 0) {
+    task->state = TaskDescriptor::State::kIoBlocked;
+    pushBlocked(readersHead, readersTail, task);
+    return false;
+  }
+  task->tf.r0 = copyToTask(task);
+  return true;
+}
+
+bool UartDriver::write(TaskDescriptor *task) {
+  // remember the total length to return once everything is buffered
+  task->tf.r3 = task->tf.r2;
+  if ((int)task->tf.r2 <= 0) {
+    task->tf.r0 = 0;
+    return true;
+  }
+  // queue behind earlier writers so output is never interleaved
+  bool done = !writersHead && copyFromTask(task);
+  fillTx();
+  if (!done) {
+    task->state = TaskDescriptor::State::kIoBlocked;
+    pushBlocked(writersHead, writersTail, task);
+    return false;
+  }
+  task->tf.r0 = task->tf.r3;
+  return true;
+}
+
+bool UartDriver::flush(TaskDescriptor *task) {
+  if (sendBuffer.size() == 0 && !writersHead) {
+    task->tf.r0 = 0;
+    return true;
+  }
+  task->state = TaskDescriptor::State::kIoBlocked;
+  pushBlocked(flushersHead, flushersTail, task);
+  return false;
+}
+
+void handleUartRead() {
+  UartDriver *driver = getDriver(curTask->tf.r0);
+  if (!driver) {
+    curTask->tf.r0 = -1;
+    taskYield();
+    return;
+  }
+  if (driver->read(curTask)) {
+    taskYield();
+  }
+}
+
+void handleUartWrite() {
+  UartDriver *driver = getDriver(curTask->tf.r0);
+  if (!driver) {
+    curTask->tf.r0 = -1;
+    taskYield();
+    return;
+  }
+  if (driver->write(curTask)) {
+    taskYield();
+  }
+}
+
+void handleUartFlush() {
+  UartDriver *driver = getDriver(curTask->tf.r0);
+  if (!driver) {
+    curTask->tf.r0 = -1;
+    taskYield();
+    return;
+  }
+  if (driver->flush(curTask)) {
+    taskYield();
+  }
+}
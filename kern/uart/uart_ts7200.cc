@@ -0,0 +1,102 @@
+#include "kern/uart.h"
+
+#include "kern/arch/ts7200.h"
+#include "kern/common.h"
+#include "lib/bwio.h"
+
+// UART register access for the TS-7200; the rest of the driver is in uart.cc
+
+KERN_INIT void UartDriver::init(unsigned int base, bool fifo, int speed,
+                                bool stp2, bool cts) {
+  this->base = base;
+  this->cts = cts;
+  recvBuffer.clear();
+  sendBuffer.clear();
+  readersHead = readersTail = nullptr;
+  writersHead = writersTail = nullptr;
+  flushersHead = flushersTail = nullptr;
+
+  bwsetfifo(base, fifo);
+  bwsetspeed(base, speed);
+  bwsetstp2(base, stp2);
+
+  volatile unsigned int *flags = (unsigned int *)(base + UART_FLAG_OFFSET);
+  volatile unsigned int *data = (unsigned int *)(base + UART_DATA_OFFSET);
+  volatile unsigned int *ctrl = (unsigned int *)(base + UART_CTRL_OFFSET);
+
+  // discard whatever arrived before the driver took over
+  while (!(*flags & RXFE_MASK)) {
+    (void)*data;
+  }
+
+  ctsHigh = *flags & CTS_MASK;
+  ctsReady = ctsHigh;
+
+  // receive interrupts stay enabled; transmit interrupt is enabled on demand
+  *ctrl = UARTEN_MASK | RIEN_MASK | RTIEN_MASK | (cts ? MSIEN_MASK : 0);
+}
+
+void UartDriver::drainRx() {
+  volatile unsigned int *flags = (unsigned int *)(base + UART_FLAG_OFFSET);
+  volatile unsigned int *data = (unsigned int *)(base + UART_DATA_OFFSET);
+  while (!(*flags & RXFE_MASK)) {
+    // drop the byte if nobody has read the buffer for a long time
+    recvBuffer.enqueue(*data);
+  }
+}
+
+void UartDriver::fillTx() {
+  volatile unsigned int *flags = (unsigned int *)(base + UART_FLAG_OFFSET);
+  volatile unsigned int *data = (unsigned int *)(base + UART_DATA_OFFSET);
+  volatile unsigned int *ctrl = (unsigned int *)(base + UART_CTRL_OFFSET);
+
+  while (sendBuffer.size() > 0 && !(*flags & TXFF_MASK)) {
+    if (cts) {
+      if (!ctsReady) {
+        break;
+      }
+      ctsReady = false;
+    }
+    *data = sendBuffer.dequeue();
+  }
+
+  // with CTS the modem status interrupt tells us when we may send again
+  if (sendBuffer.size() > 0 && (!cts || ctsReady)) {
+    *ctrl |= TIEN_MASK;
+  } else {
+    *ctrl &= ~TIEN_MASK;
+  }
+  wakeFlushers();
+}
+
+unsigned int UartDriver::handleInterrupt() {
+  volatile unsigned int *flags = (unsigned int *)(base + UART_FLAG_OFFSET);
+  volatile unsigned int *intr = (unsigned int *)(base + UART_INTR_OFFSET);
+
+  unsigned int val = *intr;
+  if (val & RTIS_MASK || val & RIS_MASK) {
+    drainRx();
+    wakeReaders();
+  }
+  if (val & MIS_MASK) {
+    bool newCts = *flags & CTS_MASK;
+    if (!ctsHigh && newCts) {
+      ctsReady = true;
+    }
+    ctsHigh = newCts;
+    *intr = 0;
+  }
+  if (val & TIS_MASK || val & MIS_MASK) {
+    fillTx();
+    if (writersHead) {
+      wakeWriters();
+      fillTx();
+    }
+  }
+  return val;
+}
+
+KERN_INIT void uartBootstrap() {
+  uartDrivers[0].init(COM1, false, 2400, true, true);
+  uartDrivers[1].init(COM2, true, 115200, false, false);
+}
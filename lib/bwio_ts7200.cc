@@ -0,0 +1,76 @@
+/*
+ * bwio_ts7200.cc - busy-wait UART access for bwio
+ *
+ * Specific to the TS-7200 ARM evaluation board
+ *
+ */
+
+#include "lib/bwio.h"
+
+#include "kern/arch/ts7200.h"
+
+/*
+ * The UARTs are initialized by RedBoot to the following state
+ * 	115,200 bps
+ * 	8 bits
+ * 	no parity
+ * 	fifos enabled
+ */
+int bwsetfifo(unsigned int channel, int state) {
+  volatile int *line = (int *)(channel + UART_LCRH_OFFSET);
+  int buf = *line;
+  buf = state ? buf | FEN_MASK : buf & ~FEN_MASK;
+  *line = buf;
+  return 0;
+}
+
+int bwsetspeed(unsigned int channel, int speed) {
+  volatile int *mid, *low;
+  int baudDiv;
+  mid = (int *)(channel + UART_LCRM_OFFSET);
+  low = (int *)(channel + UART_LCRL_OFFSET);
+  baudDiv = UARTCLK / (16 * speed) - 1;
+  if (0 < baudDiv && baudDiv <= 0xffff) {
+    *mid = (baudDiv >> 8) & 0xff;
+    *low = baudDiv & 0xff;
+    return 0;
+  }
+  return -1;
+}
+
+int bwsetstp2(unsigned int channel, int select) {
+  unsigned int base = channel;
+  int *high, val;
+  high = (int *)(base + UART_LCRH_OFFSET);
+  val = *high;
+  val = select ? val | STP2_MASK : val & ~STP2_MASK;
+  *high = val;
+  return 0;
+}
+
+int bwputc(unsigned int channel, char c) {
+  volatile int *flags, *data;
+  flags = (int *)(channel + UART_FLAG_OFFSET);
+  data = (int *)(channel + UART_DATA_OFFSET);
+
+  while ((*flags & TXFF_MASK))
+    ;
+  *data = c;
+  while (!(*flags & TXFE_MASK))
+    ;
+
+  return 0;
+}
+
+int bwgetc(unsigned int channel) {
+  volatile int *flags, *data;
+  flags = (int *)(channel + UART_FLAG_OFFSET);
+  data = (int *)(channel + UART_DATA_OFFSET);
+
+  unsigned char c;
+
+  while ((*flags & RXFE_MASK))
+    ;
+  c = *data;
+  return c;
+}
@@ -1,70 +1,49 @@
 #include "lib/io.h"
 
-#include "../user/include/uart_server.h"
-#include "kern/arch/ts7200.h"
+#include "kern/arch.h"
 #include "lib/bwio.h"
-#include "user/message.h"
+#include "user/uart.h"
 
-int uart1Tid, uart2Tid;
+#define OUT_BUFFER_SIZE 128
 
-void ioBootstrap(int _uart1Tid, int _uart2Tid) {
-  uart1Tid = _uart1Tid;
-  uart2Tid = _uart2Tid;
-}
+namespace {
 
-/*
- * The UARTs are initialized by RedBoot to the following state
- * 	115,200 bps
- * 	8 bits
- * 	no parity
- * 	fifos enabled
- */
-int setfifo(unsigned int channel, int state) {
-  volatile int *line = (int *)(channel + UART_LCRH_OFFSET);
-  int buf = *line;
-  buf = state ? buf | FEN_MASK : buf & ~FEN_MASK;
-  *line = buf;
-  return 0;
-}
+// collects formatted output so that one uartWrite covers a whole printf
+struct OutBuffer {
+  unsigned int channel;
+  int len;
+  char data[OUT_BUFFER_SIZE];
 
-int setspeed(unsigned int channel, int speed) {
-  volatile int *mid, *low;
-  int baudDiv;
-  mid = (int *)(channel + UART_LCRM_OFFSET);
-  low = (int *)(channel + UART_LCRL_OFFSET);
-  baudDiv = UARTCLK / (16 * speed) - 1;
-  if (0 < baudDiv && baudDiv <= 0xffff) {
-    *mid = (baudDiv >> 8) & 0xff;
-    *low = baudDiv & 0xff;
-    return 0;
+  OutBuffer(unsigned int channel) : channel{channel}, len{0} {}
+
+  void putc(char ch) {
+    if (len == OUT_BUFFER_SIZE) {
+      flush();
+    }
+    data[len++] = ch;
   }
-  return -1;
-}
 
-int setstp2(unsigned int channel, int select) {
-  unsigned int base = channel;
-  int *high, val;
-  high = (int *)(base + UART_LCRH_OFFSET);
-  val = *high;
-  val = select ? val | STP2_MASK : val & ~STP2_MASK;
-  *high = val;
-  return 0;
-}
+  void putw(int n, char fc, const char *bf) {
+    char ch;
+    const char *p = bf;
 
-int putc(unsigned int channel, char ch) {
-  uart::Msg msg;
-  msg.action = uart::Action::Putc;
-  msg.data = ch;
-  int retVal = -1;
-  switch (channel) {
-    case COM1:
-      retVal = send(uart1Tid, msg);
-      break;
-    case COM2:
-      retVal = send(uart2Tid, msg);
-      break;
+    while (*p++ && n > 0) n--;
+    while (n-- > 0) putc(fc);
+    while ((ch = *bf++)) putc(ch);
   }
-  return retVal > -1 ? 0 : -1;
+
+  void flush() {
+    if (len > 0) {
+      uartWrite(channel, data, len);
+    }
+    len = 0;
+  }
+};
+
+}  // namespace
+
+int putc(unsigned int channel, char ch) {
+  return uartWrite(channel, &ch, 1) == 1 ? 0 : -1;
 }
 
 char c2x(char ch) {
@@ -91,12 +70,10 @@ int putr(unsigned int channel, unsigned int reg) {
 
 int putstr(unsigned int channel, const char *str) {
   int count = 0;
-  while (*str) {
-    if (putc(channel, *str) < 0) return -1;
-    ++str;
+  while (str[count]) {
     ++count;
   }
-  return count;
+  return uartWrite(channel, str, count) == count ? count : -1;
 }
 
 void putw(unsigned int channel, int n, char fc, const char *bf) {
@@ -109,18 +86,8 @@ void putw(unsigned int channel, int n, char fc, const char *bf) {
 }
 
 int getc(unsigned int channel) {
-  uart::Msg msg{uart::Action::Getc};
   char ch;
-  int retVal = -1;
-  switch (channel) {
-    case COM1:
-      retVal = send(uart1Tid, msg, ch);
-      break;
-    case COM2:
-      retVal = send(uart2Tid, msg, ch);
-      break;
-  }
-  return retVal > -1 ? ch : -1;
+  return uartRead(channel, &ch, 1) == 1 ? ch : -1;
 }
 
 int a2d(char ch) {
@@ -173,13 +140,14 @@ void i2a(int num, char *bf) {
 }
 
 void format(unsigned int channel, const char *fmt, va_list va) {
+  OutBuffer out{channel};
   char bf[12];
   char ch, lz;
   int w;
 
   while ((ch = *(fmt++))) {
     if (ch != '%')
-      putc(channel, ch);
+      out.putc(ch);
     else {
       lz = 0;
       w = 0;
@@ -203,31 +171,33 @@ void format(unsigned int channel, const char *fmt, va_list va) {
       }
       switch (ch) {
         case 0:
+          out.flush();
           return;
         case 'c':
-          putc(channel, va_arg(va, char));
+          out.putc((char)va_arg(va, int));
           break;
         case 's':
-          putw(channel, w, 0, va_arg(va, char *));
+          out.putw(w, 0, va_arg(va, char *));
           break;
         case 'u':
           ui2a(va_arg(va, unsigned int), 10, bf);
-          putw(channel, w, lz, bf);
+          out.putw(w, lz, bf);
           break;
         case 'd':
           i2a(va_arg(va, int), bf);
-          putw(channel, w, lz, bf);
+          out.putw(w, lz, bf);
           break;
         case 'x':
           ui2a(va_arg(va, unsigned int), 16, bf);
-          putw(channel, w, lz, bf);
+          out.putw(w, lz, bf);
           break;
         case '%':
-          putc(channel, ch);
+          out.putc(ch);
           break;
       }
     }
   }
+  out.flush();
 }
 
 void printf(unsigned int channel, const char *fmt, ...) {
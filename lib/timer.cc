@@ -1,6 +1,6 @@
 #include "lib/timer.h"
 
-#include "kern/arch/ts7200.h"
+#include "kern/arch.h"
 
 namespace timer {
 
@@ -11,7 +11,7 @@ void load(unsigned int timerBase, unsigned int initialTimeMs) {
 
 void start(unsigned int timerBase) {
   volatile unsigned int *addr = (unsigned int *)(timerBase + CTRL_OFFSET);
-  *addr = 0b11001000;
+  *addr = TIMER_CTRL_START(timerBase);
 }
 
 void stop(unsigned int timerBase) {
@@ -24,4 +24,11 @@ unsigned int getTick(unsigned int timerBase) {
   return *addr;
 }
 
+void startFreeRunning(unsigned int timerBase, unsigned int counts) {
+  stop(timerBase);
+  *(volatile unsigned int *)(timerBase + LDR_OFFSET) = counts;
+  *(volatile unsigned int *)(timerBase + CTRL_OFFSET) =
+      TIMER_CTRL_START(timerBase) & ~MODE_MASK;
+}
+
 }  // namespace timer
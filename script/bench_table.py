@@ -0,0 +1,68 @@
+#!/usr/bin/python3
+
+# Turns the BENCH lines printed by perf_test::benchmarkSuite() into one table
+# with a row per benchmark and a column per build variant (ENABLE_OPT,
+# ENABLE_CACHE and ENABLE_ICACHE_LOCK). Logs of several builds, or several
+# runs of one build, can be given at once; repeated runs show their median.
+#
+# usage: bench_table.py <terminal log> [<terminal log> ...] [--relative]
+
+import argparse
+import statistics
+
+
+def read_bench(log_files):
+    results = {}  # (name, unit) -> variant -> values
+    variants = []
+    for log_file in log_files:
+        with open(log_file, "r", errors="replace") as f:
+            for line in f:
+                fields = line.strip().split()
+                if len(fields) != 7 or fields[0] != "BENCH":
+                    continue
+                variant = " ".join(fields[1:4])
+                if variant not in variants:
+                    variants.append(variant)
+                results.setdefault((fields[4], fields[6]), {}).setdefault(
+                    variant, []).append(int(fields[5]))
+    return results, variants
+
+
+def format_table(results, variants, relative: bool):
+    header = ["benchmark", "unit"] + variants
+    rows = []
+    for (name, unit), by_variant in results.items():
+        medians = [statistics.median(by_variant[variant])
+                   if variant in by_variant else None for variant in variants]
+        row = [name, unit]
+        for median in medians:
+            if median is None:
+                row.append("-")
+            elif relative and medians[0]:
+                row.append("{:.0f}%".format(median * 100 / medians[0]))
+            else:
+                row.append(str(round(median)))
+        rows.append(row)
+
+    widths = [max(len(row[i]) for row in [header] + rows)
+              for i in range(len(header))]
+    lines = []
+    for row in [header] + rows:
+        cells = [row[0].ljust(widths[0]), row[1].ljust(widths[1])]
+        cells += [cell.rjust(width) for cell, width in zip(row[2:], widths[2:])]
+        lines.append("  ".join(cells))
+    return "\n".join(lines)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("logs", nargs="+")
+    parser.add_argument("--relative", action="store_true",
+                        help="show each variant as a percentage of the first")
+    args = parser.parse_args()
+
+    results, variants = read_bench(args.logs)
+    if not results:
+        print("no BENCH lines found")
+    else:
+        print(format_table(results, variants, args.relative))
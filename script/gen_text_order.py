@@ -0,0 +1,48 @@
+#!/usr/bin/python3
+
+# Turns a symbol ordering file into a linker script fragment that places the
+# listed functions at the front of .text in the given order. Requires the
+# objects to be compiled with -ffunction-sections.
+#
+# usage: gen_text_order.py <ordering file> <output .ld>
+
+import sys
+
+
+def read_order(in_file: str):
+    entries = []
+    counted = False
+    with open(in_file, "r") as f:
+        for line in f:
+            line = line.split("#", 1)[0].strip()
+            if not line:
+                continue
+            fields = line.split()
+            if len(fields) == 2 and fields[0].isdigit():
+                entries.append((int(fields[0]), fields[1]))
+                counted = True
+            else:
+                entries.append((0, fields[0]))
+    if counted:
+        # stable, so equal counts keep the file order
+        entries.sort(key=lambda e: -e[0])
+    names = []
+    for _, name in entries:
+        if name not in names:
+            names.append(name)
+    return names
+
+
+def generate_ld(in_file: str, file: str):
+    names = read_order(in_file)
+    with open(file, "w") as f:
+        f.write("/* generated by script/gen_text_order.py from {} */\n".format(in_file))
+        for name in names:
+            if name.endswith(".o"):
+                f.write("*{}(.text .text.*)\n".format(name))
+            else:
+                f.write("*(.text.{})\n".format(name))
+
+
+if __name__ == "__main__":
+    generate_ld(sys.argv[1], sys.argv[2])
@@ -0,0 +1,80 @@
+#!/usr/bin/python3
+
+# Turns the message-flow profile printed by the "flow dump" console command
+# into a Graphviz graph: one node per task, one edge per sender/receiver pair.
+#
+# usage: msg_flow.py <terminal log> <out.dot> [--name TID=NAME ...]
+# render with: dot -Tsvg out.dot -o out.svg
+
+import argparse
+
+TIMER3_FRQ = 508000
+
+
+def read_flow(log_file: str):
+    flows = []
+    peaks = {}
+    with open(log_file, "r", errors="replace") as f:
+        for line in f:
+            fields = line.strip().split()
+            if len(fields) == 7 and fields[0] == "FLOW":
+                sender, receiver, count, size, send_blocked, reply_blocked = map(
+                    int, fields[1:])
+                flows.append((sender, receiver, count, size,
+                              send_blocked * 1000000 // TIMER3_FRQ,
+                              reply_blocked * 1000000 // TIMER3_FRQ))
+            elif len(fields) == 3 and fields[0] == "QUEUE":
+                peaks[int(fields[1])] = int(fields[2])
+    return flows, peaks
+
+
+def generate_dot(flows, peaks, names, out_file: str):
+    tids = sorted({tid for flow in flows for tid in flow[:2]} | set(peaks))
+    max_count = max([flow[2] for flow in flows] + [1])
+    with open(out_file, "w") as f:
+        f.write("digraph msg_flow {\n")
+        f.write("  node [shape=box, fontname=monospace];\n")
+        f.write("  edge [fontname=monospace, fontsize=10];\n")
+        for tid in tids:
+            label = names.get(tid, "task {}".format(tid))
+            if tid in peaks:
+                label += "\\npeak queue {}".format(peaks[tid])
+            f.write('  t{} [label="{}"];\n'.format(tid, label))
+        for sender, receiver, count, size, send_us, reply_us in sorted(
+                flows, key=lambda flow: -flow[2]):
+            label = "{} msgs, {} B".format(count, size)
+            if count > 0:
+                label += "\\nsend {} us, reply {} us avg".format(
+                    send_us // count, reply_us // count)
+            width = 1 + 4 * count / max_count
+            f.write('  t{} -> t{} [label="{}", penwidth={:.1f}];\n'.format(
+                sender, receiver, label, width))
+        f.write("}\n")
+
+
+def print_table(flows, names):
+    print("{:>16} {:>16} {:>8} {:>9} {:>12} {:>12}".format(
+        "sender", "receiver", "msgs", "bytes", "send us", "reply us"))
+    for sender, receiver, count, size, send_us, reply_us in sorted(
+            flows, key=lambda flow: -(flow[4] + flow[5])):
+        print("{:>16} {:>16} {:>8} {:>9} {:>12} {:>12}".format(
+            names.get(sender, sender), names.get(receiver, receiver), count,
+            size, send_us, reply_us))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("log", help="terminal log containing a flow dump")
+    parser.add_argument("out", help="Graphviz file to write")
+    parser.add_argument("--name", action="append", default=[],
+                        help="label a task, e.g. --name 2=clock")
+    args = parser.parse_args()
+
+    names = {}
+    for name in args.name:
+        tid, label = name.split("=", 1)
+        names[int(tid)] = label
+
+    flows, peaks = read_flow(args.log)
+    generate_dot(flows, peaks, names, args.out)
+    print_table(flows, names)
@@ -0,0 +1,128 @@
+#!/usr/bin/python3
+
+# Symbolizes the histogram printed by the "prof dump" console command against
+# the kernel image and prints flat and per-task profiles.
+#
+# usage: profile.py <terminal log> [--elf kern/kmain.elf] [--lines N]
+#                   [--order script/text_order.txt]
+
+import argparse
+import bisect
+import subprocess
+from collections import defaultdict
+
+XBINDIR = "/u/cs452/public/xdev/bin"
+
+
+def read_samples(log_file: str):
+    samples = []
+    total = 0
+    with open(log_file, "r", errors="replace") as f:
+        for line in f:
+            fields = line.strip().split()
+            if len(fields) < 2 or fields[0] != "PROF":
+                continue
+            if fields[1] == "total":
+                total = int(fields[2])
+            elif fields[1] != "end":
+                samples.append((int(fields[1], 16), int(fields[2]), int(fields[3])))
+    return samples, total
+
+
+def read_symbols(nm: str, elf: str):
+    def run(args):
+        out = subprocess.run([nm, "-n", "--defined-only"] + args + [elf],
+                             capture_output=True, text=True, check=True).stdout
+        symbols = []
+        for line in out.splitlines():
+            fields = line.split(maxsplit=2)
+            if len(fields) == 3 and fields[1] in "tTwW":
+                symbols.append((int(fields[0], 16), fields[2]))
+        return symbols
+
+    mangled = run([])
+    demangled = run(["-C"])
+    addrs = [addr for addr, _ in mangled]
+    names = [(name, pretty) for (_, name), (_, pretty) in zip(mangled, demangled)]
+    return addrs, names
+
+
+def symbolize(addrs, names, pc: int):
+    i = bisect.bisect_right(addrs, pc) - 1
+    if i < 0:
+        return ("??", "??")
+    return names[i]
+
+
+def print_table(title: str, counts, total: int, limit: int):
+    print(title)
+    print("{:>8} {:>7}  {}".format("samples", "%", "function"))
+    for name, count in sorted(counts.items(), key=lambda e: -e[1])[:limit]:
+        print("{:>8} {:>6.2f}%  {}".format(count, count * 100 / total, name))
+    print()
+
+
+def print_lines(addr2line: str, elf: str, samples, total: int, limit: int):
+    by_pc = defaultdict(int)
+    for pc, _, count in samples:
+        by_pc[pc] += count
+    top = sorted(by_pc.items(), key=lambda e: -e[1])[:limit]
+    out = subprocess.run([addr2line, "-f", "-C", "-e", elf] +
+                         ["{:x}".format(pc) for pc, _ in top],
+                         capture_output=True, text=True, check=True).stdout
+    lines = out.splitlines()
+    print("hottest lines")
+    for i, (pc, count) in enumerate(top):
+        print("{:>8} {:>6.2f}%  {:08x} {} {}".format(
+            count, count * 100 / total, pc, lines[2 * i], lines[2 * i + 1]))
+    print()
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("log", help="terminal log containing a prof dump")
+    parser.add_argument("--elf", default="kern/kmain.elf")
+    parser.add_argument("--nm", default=XBINDIR + "/arm-none-eabi-nm")
+    parser.add_argument("--addr2line", default=XBINDIR + "/arm-none-eabi-addr2line")
+    parser.add_argument("--top", type=int, default=20, help="rows per table")
+    parser.add_argument("--lines", type=int, default=0,
+                        help="also show the N hottest source lines")
+    parser.add_argument("--order", help="write 'count symbol' lines for gen_text_order.py")
+    args = parser.parse_args()
+
+    samples, total = read_samples(args.log)
+    recorded = sum(count for _, _, count in samples)
+    if recorded == 0:
+        print("no samples")
+        return
+    print("{} samples, {} dropped by a full histogram\n".format(
+        total, max(total - recorded, 0)))
+
+    addrs, names = read_symbols(args.nm, args.elf)
+    flat = defaultdict(int)
+    flat_mangled = defaultdict(int)
+    per_task = defaultdict(lambda: defaultdict(int))
+    for pc, tid, count in samples:
+        mangled, pretty = symbolize(addrs, names, pc)
+        flat[pretty] += count
+        flat_mangled[mangled] += count
+        per_task[tid][pretty] += count
+
+    print_table("flat profile", flat, recorded, args.top)
+    for tid, counts in sorted(per_task.items(),
+                              key=lambda e: -sum(e[1].values())):
+        task_total = sum(counts.values())
+        print_table("task {} ({:.2f}% of samples)".format(
+            tid, task_total * 100 / recorded), counts, task_total, args.top)
+    if args.lines > 0:
+        print_lines(args.addr2line, args.elf, samples, recorded, args.lines)
+    if args.order:
+        with open(args.order, "w") as f:
+            f.write("# generated by script/profile.py from {}\n".format(args.log))
+            for name, count in sorted(flat_mangled.items(), key=lambda e: -e[1]):
+                if name != "??":
+                    f.write("{} {}\n".format(count, name))
+
+
+if __name__ == "__main__":
+    main()
@@ -14,7 +14,6 @@
 #include "perf_test.h"
 #include "rps.h"
 #include "stats.h"
-#include "uart_server.h"
 #include "user/message.h"
 #include "user/task.h"
 
@@ -36,22 +35,23 @@ void startPerfTest() {
 }
 
 void boot() {
-  create(0, nameServer);
-  create(0, clockServer);
-  uart::bootstrap();
+  create(0, nameServer, STACK_SMALL);
+  create(0, clockServer, STACK_SMALL);
 
-  create(1, marklin::cmdServer);
+  create(1, marklin::cmdServer, STACK_SMALL);
 
-  create(2, marklin::ReservationServer::runServer);
+  create(2, marklin::ReservationServer::runServer, STACK_SMALL);
 
   create(1, marklin::runWorld);
 
   create(2, marklin::runRouting);
 
-  create(2, view::displayServer);
-  create(2, consoleReader);
+  int displayServerTid = create(2, view::displayServer);
+  // redraw bursts must not starve routing, which shares priority 2
+  setBudget(displayServerTid, 30000, 10);
+  create(2, consoleReader, STACK_SMALL);
 
-  create(3, stats);
+  create(3, stats, STACK_TINY);
 
-  create(7, idleTask);
+  create(7, idleTask, STACK_TINY);
 }
@@ -9,12 +9,79 @@ int delay(int tid, int ticks);
 
 int delayUntil(int tid, int ticks);
 
+/**
+ * @brief have the clock server release the caller every period ticks from
+ * now, without a request per period; a period of 0 cancels and a new period
+ * takes effect from the next release
+ *
+ * A subscriber must cancel before it exits. The server frees the slot of one
+ * that did not only when its next release comes due, so until then the slot
+ * counts against the limit.
+ *
+ * @return 0, -1 if tid is not the clock server, -2 if period < 0 or the
+ * server holds too many subscriptions
+ */
+int periodic(int tid, int period);
+
+/**
+ * @brief block until the next release of the caller's subscription
+ *
+ * @return releases missed since the previous wait returned, -1 if tid is not
+ * the clock server, -2 if the caller has no subscription
+ */
+int waitPeriod(int tid);
+
+// One-shot timers behind a handle, so that a wake-up can be moved or called
+// off by a task other than the one waiting for it. Every timer must be
+// collected with timerWait() or cancelled, or it keeps its slot.
+
+/**
+ * @brief start a timer that fires in ticks ticks
+ *
+ * @return the handle, -1 if tid is not the clock server, -2 if ticks < 0 or
+ * the server holds too many timers
+ */
+int timerStart(int tid, int ticks);
+
+/**
+ * @brief block until the timer fires, then free it; at most one task may wait
+ * on a timer
+ *
+ * @return the tick it fired at, -1 if tid is not the clock server, -2 if the
+ * handle is stale or already waited on, -3 if the timer was cancelled
+ */
+int timerWait(int tid, int handle);
+
+/**
+ * @brief make a pending timer fire in ticks ticks from now instead
+ *
+ * @return 0, -1 if tid is not the clock server, -2 if ticks < 0 or the timer
+ * is no longer pending
+ */
+int timerReschedule(int tid, int handle, int ticks);
+
+/**
+ * @brief stop a pending timer from firing and free it; its waiter returns -3
+ *
+ * @return 0, -1 if tid is not the clock server, -2 if the timer is no longer
+ * pending
+ */
+int timerCancel(int tid, int handle);
+
 void clockServer();
 
 namespace clock {
+extern unsigned int timeQueries;  // number of time()/now() calls so far
+
+// read from the kernel's tick page, no syscall involved
 int time();
+// subTick: TIMER3 counts (TIMER3_FRQ) elapsed since the tick
+void now(int &tick, unsigned int &subTick);
+
 int delay(int ticks);
 int delayUntil(int ticks);
+// microsecond resolution in tickless mode (ENABLE_TICKLESS)
+int delayUs(int us);
 }  // namespace clock
 
 #endif  // USER_NAME_SERVER_H_
\ No newline at end of file
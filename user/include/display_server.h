@@ -14,9 +14,21 @@ enum Action {
   Time,
   InvalidCmd,
   Quit,
+  // data = {train id or -1..-3, next sensor node index, tick, time diff,
+  // dist diff, velocity}
   Predict,
   Train,
-  Track
+  Track,
+  StackReport,  // data = {-1} to start a report, {index, tid, size, peak}
+  // data = {-1} to start a report,
+  // {index, tid, period, deadline, jobs, misses, overruns, worst response us}
+  PeriodReport,
+  // data = {-1} to start a report, {index, tid, priority, budget us, period,
+  // throttles, throttled ticks, demoted}
+  BudgetReport,
+  // data = {-1, total samples} to start a dump, {index, pc, tid, count},
+  // {-2} to end it
+  ProfileDump
 };
 
 enum TrainStatus {
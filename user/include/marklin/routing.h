@@ -7,6 +7,8 @@
 #include "world.h"
 
 #define ROUTING_SERVER_NAME "ROUTING_SERVER"
+// routing runs at 2; it is boosted to this while handling a reroute
+#define ROUTING_REROUTE_PRIORITY 1
 
 namespace marklin {
 
@@ -18,14 +20,23 @@ struct PathInfo {
 
 void runRouting();
 
+// the stop timer of a train, started by handleDeparture()
+struct PendingStop {
+  int timer;  // clock server timer handle, -1 if none
+  bool rerouteOnSlow;
+  bool rerouteOnStop;
+};
+
 class Routing {
   int trackSize;
   int worldTid;
   int reservationServer;
+  int clockServer;
   track_node track[TRACK_MAX];
   TrackSet trackSet;
 
   int trainStopSensor[80][3];
+  PendingStop pendingStops[80];
 
   void clearStatus();
   int route(track_node* src, track_node* dest, int destOffset,
@@ -45,6 +56,9 @@ class Routing {
   void updateTrainLoc(int trainId, track_node* dest, int offset);
   void handleDeparture(int trainId, int speed, int delay, bool rerouteOnSlow,
                        bool rerouteOnStop);
+  void scheduleStop(int trainId, int delay, bool rerouteOnSlow,
+                    bool rerouteOnStop);
+  void cancelStop(int trainId);
   void setTrainBlocked(int trainId, bool blocked);
   int calcDist(track_node* (&path)[TRACK_MAX]);
 
@@ -9,4 +9,6 @@ int registerAs(const char *name);
 
 int whoIs(const char *name);
 
+int remoteWhoIs(const char *name);
+
 #endif  // USER_NAME_SERVER_H_
\ No newline at end of file
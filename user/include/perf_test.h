@@ -3,10 +3,39 @@
 
 namespace perf_test {
 
+// index of this kernel among the instances of a host -j or -scale run, else 0
+extern int instance;
+// seed for tests that draw random inputs, such as routingTest()
+extern unsigned int seed;
+
 void sender();
 void receiver();
 void senderFirst();
 void receiverFirst();
+void uartThroughput();
+void sleepLatency();
+void maxSleepers();
+void createTest();
+void yieldTest();
+void churnTest();
+void latencyTest();
+void edfTest();
+void periodicTest();
+void timerHandleTest();
+void routingTest();
+void routingParallelTest();
+void setPriorityTest();
+void remoteEcho();
+void remoteTest();
+void remoteBadTid();
+void benchmarkSuite();
+
+/**
+ * @brief start the name server, the clock server and the idle task, run the
+ * named tests in turn and shut the kernel down. Must be the first task, at
+ * priority 1.
+ */
+void runNamed(int count, char *const names[]);
 
 }  // namespace perf_test
 
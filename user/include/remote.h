@@ -0,0 +1,33 @@
+#ifndef USER_REMOTE_H_
+#define USER_REMOTE_H_
+
+// Send/Receive/Reply between two kernels joined by a UART link. Each kernel
+// runs a gateway on its end; a task then sends to task tid on the peer with
+// send(remoteTid(tid), ...) and is reply-blocked until the peer task replies,
+// as with a local send. remoteWhoIs() looks up names on the peer.
+//
+// Messages and replies longer than REMOTE_MAX_MSG are cut. A send to a peer
+// tid that does not exist, or that arrives while the peer has too many sends
+// queued, gets an empty reply. Frames that fail the checksum are dropped, and
+// their sender stays blocked.
+
+#define REMOTE_MAX_MSG 128
+#define REMOTE_WORKERS 4  // remote sends delivered at once on this kernel
+
+namespace remote {
+
+struct Config {
+  unsigned int channel;  // UART of the link
+  int priority;          // of the gateway, its link reader and workers
+};
+
+/**
+ * @brief gateway task; create one on each kernel with the link's UART
+ *
+ * create(1, remote::gateway, remote::Config{COM1, 1}, STACK_SMALL);
+ */
+void gateway(const Config *config);
+
+}  // namespace remote
+
+#endif  // USER_REMOTE_H_
@@ -1,34 +1,129 @@
 #include "clock_server.h"
 
 #include "kern/syscall_code.h"
+#include "kern/tick_page.h"
 #include "lib/assert.h"
 #include "lib/heap.h"
 #include "lib/io.h"
 #include "lib/timer.h"
 #include "name_server.h"
-#include "user/event.h"
 #include "user/message.h"
+#include "user/sleep.h"
 #include "user/task.h"
 
-enum Action { Time = 0, Delay, DelayUntil, Update };
+// periodic subscriptions held by the server at once
+#define MAX_SUBSCRIPTIONS 16
+// timer handles held by the server at once
+#define MAX_TIMERS 32
+// notifiers asleep at once; another is only put to sleep for a deadline ahead
+// of all of theirs
+#define MAX_NOTIFIERS 16
+
+enum Action {
+  Time = 0,
+  Delay,
+  DelayUntil,
+  Update,
+  Periodic,
+  WaitPeriod,
+  TimerStart,
+  TimerWait,
+  TimerReschedule,
+  TimerCancel
+};
 
 struct DelayNode {
   int tid;
   int until;
+  int sub;  // index of the periodic subscription, -1 for a delay
 
-  DelayNode() : tid{-1}, until{-1} {}
-  DelayNode(int tid, int until) : tid{tid}, until{until} {}
+  DelayNode() : tid{-1}, until{-1}, sub{-1} {}
+  DelayNode(int tid, int until, int sub = -1)
+      : tid{tid}, until{until}, sub{sub} {}
 
   friend bool operator<(const DelayNode &l, const DelayNode &r) {
     return l.until < r.until;
   }
 };
 
+// A task woken every period ticks. Its node stays in the delay heap, moved on
+// by period at every release, until the subscription is cancelled or its
+// subscriber is found gone.
+struct Subscription {
+  int tid;       // -1 if free
+  int period;    // 0 once cancelled; freed when its node comes due
+  bool waiting;  // blocked in waitPeriod()
+  int missed;    // releases since the last wake-up of the subscriber
+
+  Subscription() : tid{-1}, period{0}, waiting{false}, missed{0} {}
+};
+
+// A one-shot timer behind a handle. While pending it is in the timer heap
+// under its index; once fired it waits there for timerWait() to collect it.
+struct Timer {
+  bool inUse;
+  int generation;  // bumped when the slot is freed, so stale handles fail
+  int waiter;      // blocked in timerWait(), -1 if none
+  int firedAt;     // tick, once fired
+
+  Timer() : inUse{false}, generation{0}, waiter{-1}, firedAt{-1} {}
+
+  int handle(int index) const { return generation * MAX_TIMERS + index; }
+
+  void free() {
+    inUse = false;
+    // handles stay non-negative
+    generation = (generation + 1) & (0x7fffffff / MAX_TIMERS);
+  }
+};
+
+// the index of a live timer, -1 for a stale or bad handle
+int timerIndex(const Timer *timers, int handle) {
+  if (handle < 0) {
+    return -1;
+  }
+  int index = handle % MAX_TIMERS;
+  const Timer &timer = timers[index];
+  return timer.inUse && timer.handle(index) == handle ? index : -1;
+}
+
 namespace clock {
 int serverTid;
-int time() { return ::time(serverTid); }
-int delay(int ticks) { return ::delay(serverTid, ticks); }
-int delayUntil(int ticks) { return ::delayUntil(serverTid, ticks); }
+unsigned int timeQueries;
+
+int time() {
+#if ENABLE_TICKLESS
+  // the kernel only publishes when it has work, so the tick is derived from
+  // TIMER3
+  int tick;
+  unsigned int subTick;
+  now(tick, subTick);
+  return tick;
+#else
+  ++timeQueries;
+  return TICK_PAGE->tick;
+#endif
+}
+
+void now(int &tick, unsigned int &subTick) {
+  ++timeQueries;
+  unsigned int seq, tickTimer, load, counter;
+  int offset;
+  do {
+    seq = TICK_PAGE->seq;
+    tick = TICK_PAGE->tick;
+    tickTimer = TICK_PAGE->tickTimer;
+    offset = TICK_PAGE->offset;
+    load = TICK_PAGE->load;
+    counter = timer::getTick(TIMER3_BASE);
+  } while (seq != TICK_PAGE->seq);
+
+  tickPageResolve(tick, subTick, offset, load, tickTimer, counter);
+}
+
+int delay(int ticks) { return sleepFor(ticks); }
+int delayUntil(int ticks) { return sleepUntil(ticks); }
+int delayUs(int us) { return sleepForUs(us); }
 }  // namespace clock
 
 int time(int tid) {
@@ -61,15 +156,84 @@ int delayUntil(int tid, int ticks) {
   return -1;
 }
 
+int periodic(int tid, int period) {
+  if (period < 0) {
+    return -2;
+  }
+  int ret = -1;
+  int msg[2] = {Action::Periodic, period};
+  if (send(tid, msg, ret) >= 0) {
+    return ret;
+  }
+  return -1;
+}
+
+int waitPeriod(int tid) {
+  int missed = -1;
+  int msg[2] = {Action::WaitPeriod, 0};
+  if (send(tid, msg, missed) >= 0) {
+    return missed;
+  }
+  return -1;
+}
+
+int timerStart(int tid, int ticks) {
+  if (ticks < 0) {
+    return -2;
+  }
+  int handle = -1;
+  int msg[2] = {Action::TimerStart, ticks};
+  if (send(tid, msg, handle) >= 0) {
+    return handle;
+  }
+  return -1;
+}
+
+int timerWait(int tid, int handle) {
+  int ret = -1;
+  int msg[2] = {Action::TimerWait, handle};
+  if (send(tid, msg, ret) >= 0) {
+    return ret;
+  }
+  return -1;
+}
+
+int timerReschedule(int tid, int handle, int ticks) {
+  if (ticks < 0) {
+    return -2;
+  }
+  int ret = -1;
+  int msg[3] = {Action::TimerReschedule, handle, ticks};
+  if (send(tid, msg, ret) >= 0) {
+    return ret;
+  }
+  return -1;
+}
+
+int timerCancel(int tid, int handle) {
+  int ret = -1;
+  int msg[2] = {Action::TimerCancel, handle};
+  if (send(tid, msg, ret) >= 0) {
+    return ret;
+  }
+  return -1;
+}
+
+/**
+ * Sleeps in the kernel until the deadline the server replies with, then
+ * reports the tick it woke at. The server keeps it blocked while nothing is
+ * due, and replies -1 when another notifier already covers its work.
+ */
 void clockNotifier() {
   int serverTid = whoIs(CLOCK_SERVER_NAME);
-  int msg[2] = {Action::Update, 0};
-  int eventRet;
+  int msg[2] = {Action::Update, clock::time()};
   while (true) {
-    eventRet = awaitEvent(IRQ_TC3UI);
-    assert(eventRet == 0);
-    ++msg[1];
-    send(serverTid, msg);
+    int until = -1;
+    send(serverTid, msg, until);
+    if (until < 0) {
+      return;
+    }
+    msg[1] = sleepUntil(until);
   }
 }
 
@@ -77,42 +241,89 @@ void clockServer() {
   registerAs(CLOCK_SERVER_NAME);
   clock::serverTid = myTid();
 
-  int tick = 0;
   int senderTid;
-  int request[2];
+  // a third int only for TimerReschedule
+  int request[3];
   MinHeap<DelayNode, 64> delayHeap;
+  Subscription subs[MAX_SUBSCRIPTIONS];
+  // the ticks pending timers fire at, by timer index
+  IndexedMinHeap<int, MAX_TIMERS> timerHeap;
+  Timer timers[MAX_TIMERS];
 
-  create(0, clockNotifier);
-
-  timer::stop(TIMER3_BASE);
-  timer::load(TIMER3_BASE, 10);
-  timer::start(TIMER3_BASE);
+  // A notifier in the kernel's timer wheel cannot be woken early, so a deadline
+  // ahead of every sleeping notifier gets one of its own: the idle one if any,
+  // else a new one. Notifiers that wake with nothing to do are dropped.
+  MinHeap<int, MAX_NOTIFIERS> notifierWakes;
+  // a notifier reply-blocked on us with no deadline to sleep for, -1 if none
+  int idleNotifier = -1;
+  // a notifier created but not yet reported in
+  bool notifierStarting = true;
+  create(0, clockNotifier, STACK_TINY);
 
   while (true) {
     int receivedLen = receive(senderTid, request);
-    assert(receivedLen == sizeof(request));
+    assert(receivedLen >= (int)(2 * sizeof(int)));
 
     int code = request[0];
     int payload = request[1];
 
     switch (code) {
       case Action::Update: {
-        tick = payload;
-        reply(senderTid);
+        int tick = payload;
+        while (notifierWakes.peekMin() && *notifierWakes.peekMin() <= tick) {
+          notifierWakes.deleteMin();
+        }
+        notifierStarting = false;
+        if (idleNotifier < 0) {
+          idleNotifier = senderTid;
+        } else {
+          reply(senderTid, -1);
+        }
         const DelayNode *node = delayHeap.peekMin();
         while (node && node->until <= tick) {
-          reply(node->tid, tick);
+          DelayNode due = *node;
           delayHeap.deleteMin();
+          if (due.sub < 0) {
+            reply(due.tid, tick);
+          } else if (subs[due.sub].period == 0 ||
+                     (!subs[due.sub].waiting && !taskAlive(due.tid))) {
+            // cancelled, or the subscriber exited without cancelling; one in
+            // waitPeriod() is blocked on us and so alive
+            subs[due.sub].tid = -1;
+          } else {
+            Subscription &sub = subs[due.sub];
+            if (sub.waiting) {
+              reply(sub.tid, sub.missed);
+              sub.waiting = false;
+              sub.missed = 0;
+            } else {
+              ++sub.missed;
+            }
+            // keep the phase, however late this update is
+            delayHeap.insert({sub.tid, due.until + sub.period, due.sub});
+          }
           node = delayHeap.peekMin();
         }
+        const int *timerTick = timerHeap.peekMin();
+        while (timerTick && *timerTick <= tick) {
+          int index = timerHeap.minId();
+          timerHeap.deleteMin();
+          if (timers[index].waiter >= 0) {
+            reply(timers[index].waiter, tick);
+            timers[index].free();
+          } else {
+            timers[index].firedAt = tick;
+          }
+          timerTick = timerHeap.peekMin();
+        }
         break;
       }
       case Action::Time:
-        reply(senderTid, tick);
+        reply(senderTid, clock::time());
         break;
       case Action::Delay:
         assert(payload >= 0);
-        delayHeap.insert({senderTid, tick + payload});
+        delayHeap.insert({senderTid, clock::time() + payload});
         break;
       case Action::DelayUntil:
         if (payload >= 0) {
@@ -121,9 +332,136 @@ void clockServer() {
           reply(senderTid, -2);
         }
         break;
+      case Action::Periodic: {
+        // a task has at most one subscription; a cancelled one is reused
+        // while its node is still in the heap
+        int free = -1, own = -1;
+        for (int i = 0; i < MAX_SUBSCRIPTIONS; ++i) {
+          if (subs[i].tid == senderTid) {
+            own = i;
+          } else if (subs[i].tid == -1 && free == -1) {
+            free = i;
+          }
+        }
+        if (own >= 0) {
+          // takes effect from the next release on
+          subs[own].period = payload;
+          reply(senderTid, 0);
+        } else if (payload == 0) {
+          reply(senderTid, 0);
+        } else if (free >= 0) {
+          subs[free].tid = senderTid;
+          subs[free].period = payload;
+          subs[free].waiting = false;
+          subs[free].missed = 0;
+          delayHeap.insert({senderTid, clock::time() + payload, free});
+          reply(senderTid, 0);
+        } else {
+          reply(senderTid, -2);
+        }
+        break;
+      }
+      case Action::WaitPeriod: {
+        Subscription *sub = nullptr;
+        for (Subscription &s : subs) {
+          if (s.tid == senderTid && s.period > 0) {
+            sub = &s;
+          }
+        }
+        if (sub) {
+          sub->waiting = true;
+        } else {
+          reply(senderTid, -2);
+        }
+        break;
+      }
+      case Action::TimerStart: {
+        int index = 0;
+        while (index < MAX_TIMERS && timers[index].inUse) {
+          ++index;
+        }
+        if (payload < 0 || index == MAX_TIMERS) {
+          reply(senderTid, -2);
+          break;
+        }
+        Timer &timer = timers[index];
+        timer.inUse = true;
+        timer.waiter = -1;
+        if (payload == 0) {
+          timer.firedAt = clock::time();
+        } else {
+          timerHeap.insert(index, clock::time() + payload);
+        }
+        reply(senderTid, timer.handle(index));
+        break;
+      }
+      case Action::TimerWait: {
+        int index = timerIndex(timers, payload);
+        if (index < 0 || timers[index].waiter >= 0) {
+          reply(senderTid, -2);
+        } else if (timerHeap.contains(index)) {
+          timers[index].waiter = senderTid;
+        } else {
+          reply(senderTid, timers[index].firedAt);
+          timers[index].free();
+        }
+        break;
+      }
+      case Action::TimerReschedule: {
+        int index = timerIndex(timers, payload);
+        int ticks = request[2];
+        if (receivedLen != sizeof(request) || ticks < 0 || index < 0 ||
+            !timerHeap.contains(index)) {
+          reply(senderTid, -2);
+        } else {
+          timerHeap.update(index, clock::time() + ticks);
+          reply(senderTid, 0);
+        }
+        break;
+      }
+      case Action::TimerCancel: {
+        int index = timerIndex(timers, payload);
+        if (index < 0 || !timerHeap.contains(index)) {
+          // too late if it has fired, even if no one has collected it
+          reply(senderTid, -2);
+          break;
+        }
+        timerHeap.remove(index);
+        if (timers[index].waiter >= 0) {
+          reply(timers[index].waiter, -3);
+        }
+        timers[index].free();
+        reply(senderTid, 0);
+        break;
+      }
       default:
         println(COM2, "[Clock Server]: fatal error unknown action");
         assert(false);
     }
+
+    // no updates, and in tickless mode no timer interrupts, until the next
+    // deadline
+    const DelayNode *node = delayHeap.peekMin();
+    const int *timerTick = timerHeap.peekMin();
+    if (!node && !timerTick) {
+      continue;
+    }
+    int next = node ? node->until : *timerTick;
+    if (node && timerTick && *timerTick < next) {
+      next = *timerTick;
+    }
+    const int *wake = notifierWakes.peekMin();
+    if (wake && *wake <= next) {
+      continue;
+    }
+    if (idleNotifier >= 0) {
+      reply(idleNotifier, next);
+      idleNotifier = -1;
+      notifierWakes.insert(next);
+    } else if (!notifierStarting) {
+      // it asks for work with an update as soon as it runs
+      create(0, clockNotifier, STACK_TINY);
+      notifierStarting = true;
+    }
   }
 }
\ No newline at end of file
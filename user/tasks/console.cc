@@ -6,8 +6,9 @@
 #include "marklin/world.h"
 #include "marklin_server.h"
 #include "name_server.h"
-#include "uart_server.h"
 #include "user/message.h"
+#include "user/profile.h"
+#include "user/sleep.h"
 #include "user/sys.h"
 #include "user/task.h"
 
@@ -52,6 +53,58 @@ void clearInvalidCommand(int displayServerTid) {
   send(displayServerTid, msg);
 }
 
+/**
+ * @brief stop the profiler and send its histogram for script/profile.py to
+ * the display server, which prints it between screen updates
+ */
+void dumpProfile(int displayServerTid) {
+  int total = profileControl(0);
+  send(displayServerTid, view::Msg{view::Action::ProfileDump, {-1, total}, 2});
+  ProfileSample sample;
+  for (int i = 0;; ++i) {
+    int ret = profileRead(i, &sample);
+    if (ret == -2) {
+      break;
+    }
+    if (ret == 0) {
+      send(displayServerTid,
+           view::Msg{view::Action::ProfileDump,
+                     {i, (int)sample.pc, sample.tid, sample.count},
+                     4});
+    }
+  }
+  send(displayServerTid, view::Msg{view::Action::ProfileDump, {-2}, 1});
+}
+
+/**
+ * @brief print the message-flow profile for script/msg_flow.py
+ */
+void dumpMsgFlow() {
+  println(COM2, "\033[2J\033[HFLOW begin");
+  MsgFlow flow;
+  for (int i = 0;; ++i) {
+    int ret = msgFlowRead(i, &flow);
+    if (ret == -2) {
+      break;
+    }
+    if (ret == 0) {
+      println(COM2, "FLOW %d %d %d %d %u %u", flow.sender, flow.receiver,
+              flow.count, flow.bytes, flow.sendBlocked, flow.replyBlocked);
+    }
+  }
+  MsgQueuePeak peak;
+  for (int i = 0;; ++i) {
+    int ret = msgQueueRead(i, &peak);
+    if (ret == -2) {
+      break;
+    }
+    if (ret == 0) {
+      println(COM2, "QUEUE %d %d", peak.tid, peak.peak);
+    }
+  }
+  println(COM2, "FLOW end");
+}
+
 void handleCmd(char* cmd, int displayServerTid, int marklinServerTid,
                int worldTid) {
   if (cmd[0] == 0) {
@@ -178,13 +231,108 @@ void handleCmd(char* cmd, int displayServerTid, int marklinServerTid,
     send(worldTid, marklin::Msg{marklin::Msg::Action::SetDestination,
                                 {trainNum, destIdx, destOffset * 1000, 10},
                                 4});
+  } else if (String{cmds[0]} == "prof") {
+    if (cmdsLen != 2) {
+      showInvalidCommand(displayServerTid);
+      return;
+    }
+    int hz;
+    if (String{cmds[1]} == "dump") {
+      clearInvalidCommand(displayServerTid);
+      dumpProfile(displayServerTid);
+    } else if (parseInt(cmds[1], hz) && profileControl(hz) >= 0) {
+      clearInvalidCommand(displayServerTid);
+    } else {
+      showInvalidCommand(displayServerTid);
+    }
+  } else if (String{cmds[0]} == "flow") {
+    if (cmdsLen != 2) {
+      showInvalidCommand(displayServerTid);
+      return;
+    }
+    if (String{cmds[1]} == "dump") {
+      clearInvalidCommand(displayServerTid);
+      dumpMsgFlow();
+    } else if (String{cmds[1]} == "reset") {
+      clearInvalidCommand(displayServerTid);
+      msgFlowReset();
+    } else {
+      showInvalidCommand(displayServerTid);
+    }
+  } else if (String{cmds[0]} == "period") {
+    if (cmdsLen != 1) {
+      showInvalidCommand(displayServerTid);
+      return;
+    }
+    clearInvalidCommand(displayServerTid);
+    send(displayServerTid, view::Msg{view::Action::PeriodReport, {-1}, 1});
+    PeriodStats stats;
+    int count = 0;
+    for (int i = 0;; ++i) {
+      int ret = periodStats(i, &stats);
+      if (ret == -2) {
+        break;
+      }
+      if (ret == 0) {
+        int worstUs = stats.worstResponse * 1000 / (TIMER3_FRQ / 1000);
+        send(displayServerTid,
+             view::Msg{view::Action::PeriodReport,
+                       {count++, stats.tid, stats.period, stats.deadline,
+                        stats.jobs, stats.misses, stats.overruns, worstUs},
+                       8});
+      }
+    }
+  } else if (String{cmds[0]} == "budget") {
+    if (cmdsLen != 1) {
+      showInvalidCommand(displayServerTid);
+      return;
+    }
+    clearInvalidCommand(displayServerTid);
+    send(displayServerTid, view::Msg{view::Action::BudgetReport, {-1}, 1});
+    BudgetStats stats;
+    int count = 0;
+    for (int i = 0;; ++i) {
+      int ret = budgetStats(i, &stats);
+      if (ret == -2) {
+        break;
+      }
+      if (ret == 0) {
+        send(displayServerTid,
+             view::Msg{view::Action::BudgetReport,
+                       {count++, stats.tid, stats.priority, stats.budget,
+                        stats.period, stats.throttles, stats.throttledTicks,
+                        stats.demoted},
+                       8});
+      }
+    }
+  } else if (String{cmds[0]} == "stack") {
+    if (cmdsLen != 1) {
+      showInvalidCommand(displayServerTid);
+      return;
+    }
+    clearInvalidCommand(displayServerTid);
+    send(displayServerTid, view::Msg{view::Action::StackReport, {-1}, 1});
+    StackProfile profile;
+    int count = 0;
+    for (int i = 0;; ++i) {
+      int ret = stackProfile(i, &profile);
+      if (ret == -2) {
+        break;
+      }
+      if (ret == 0) {
+        send(displayServerTid,
+             view::Msg{view::Action::StackReport,
+                       {count++, profile.tid, profile.size, profile.peak},
+                       4});
+      }
+    }
   } else {
     showInvalidCommand(displayServerTid);
   }
 }
 
 void render(int displayServerTid, int ch) {
-  view::Msg msg{view::Action::Input, {(unsigned int)ch}};
+  view::Msg msg{view::Action::Input, {ch}};
   send(displayServerTid, msg);
 }
 
@@ -169,24 +169,116 @@ void renderInvalidCmd(Cursor &cursor, int enable) {
 }
 
 void renderTime(Cursor &cursor, int *data) {
-  int sysTime = data[0];
+  // the first report can come at tick 0; keep the fraction from dividing by 0
+  int sysTime = data[0] > 0 ? data[0] : 1;
   int idleTime = data[1];
+  int timeQueries = data[2];
+  int stackKb = data[3];
   int sysTimeMin, sysTimeSec, sysTimeMs, idleTimeMin, idleTimeSec, idleTimeMs;
   parseTime(data[0], sysTimeMin, sysTimeSec, sysTimeMs);
   parseTime(data[1], idleTimeMin, idleTimeSec, idleTimeMs);
 
   Cursor::hideCursor();
   cursor.setC(1);
-  printf(COM2, "sys: %02d:%02d.%d, idle: %02d:%02d.%d, idle fraction: %u.%u%%",
+  printf(COM2,
+         "sys: %02d:%02d.%d, idle: %02d:%02d.%d, idle fraction: %u.%u%%, "
+         "time queries: %d/s, stack: %d KB",
          sysTimeMin, sysTimeSec, sysTimeMs / 100, idleTimeMin, idleTimeSec,
          idleTimeMs / 100, idleTime * 100 / sysTime,
-         (idleTime * 1000 / sysTime) % 10);
+         (idleTime * 1000 / sysTime) % 10, timeQueries, stackKb);
   cursor.deleteLine();
 }
 
-void renderPredict(Cursor &cursor, int *data) {
+void renderStackReport(Cursor &cursor, int *data) {
+  const int entriesPerRow = 4;
+  const int entryWidth = 20;
+  const int maxRows = 16;
+  int index = data[0];
+  Cursor::hideCursor();
+  if (index < 0) {
+    for (int r = 0; r <= maxRows; ++r) {
+      cursor.set(cursor.initR + r, 1);
+      cursor.deleteLine();
+    }
+    cursor.set(cursor.initR, 1);
+    printf(COM2, "Stack usage in bytes (tid peak/size)");
+    return;
+  }
+  if (index / entriesPerRow >= maxRows) {
+    return;
+  }
+  int tid = data[1];
+  int size = data[2];
+  int peak = data[3];
+  cursor.set(cursor.initR + 1 + index / entriesPerRow,
+             1 + index % entriesPerRow * entryWidth);
+  if (peak < 0) {
+    printf(COM2, "t%4d      ?/%6d", tid, size);
+  } else {
+    printf(COM2, "t%4d %6d/%6d", tid, peak, size);
+  }
+}
+
+void renderPeriodReport(Cursor &cursor, int *data) {
+  const int maxRows = 16;
+  int index = data[0];
+  Cursor::hideCursor();
+  if (index < 0) {
+    for (int r = 0; r <= maxRows; ++r) {
+      cursor.set(cursor.initR + r, 1);
+      cursor.deleteLine();
+    }
+    cursor.set(cursor.initR, 1);
+    printf(COM2, "Periodic tasks (ticks, worst response in us)");
+    return;
+  }
+  if (index >= maxRows) {
+    return;
+  }
+  cursor.set(cursor.initR + 1 + index, 1);
+  printf(COM2,
+         "t%4d period %3d deadline %3d jobs %7d miss %5d overrun %5d "
+         "worst %7d",
+         data[1], data[2], data[3], data[4], data[5], data[6], data[7]);
+}
+
+void renderBudgetReport(Cursor &cursor, int *data) {
+  const int maxRows = 16;
+  int index = data[0];
+  Cursor::hideCursor();
+  if (index < 0) {
+    for (int r = 0; r <= maxRows; ++r) {
+      cursor.set(cursor.initR + r, 1);
+      cursor.deleteLine();
+    }
+    cursor.set(cursor.initR, 1);
+    printf(COM2, "CPU budgets (us per period in ticks)");
+    return;
+  }
+  if (index >= maxRows) {
+    return;
+  }
+  cursor.set(cursor.initR + 1 + index, 1);
+  printf(COM2,
+         "t%4d prio %d budget %6d/%3d throttled %5d times %7d ticks%s",
+         data[1], data[2], data[3], data[4], data[5], data[6],
+         data[7] ? " (demoted)" : "");
+}
+
+void renderProfileDump(int *data) {
+  Cursor::hideCursor();
+  if (data[0] == -1) {
+    println(COM2, "\033[2J\033[HPROF total %d", data[1]);
+  } else if (data[0] == -2) {
+    println(COM2, "PROF end");
+  } else {
+    println(COM2, "PROF %x %d %d", data[1], data[2], data[3]);
+  }
+}
+
+void renderPredict(Cursor &cursor, int *data, track_node *track) {
   int trainId = data[0];
-  const char *nextSensorName = (const char *)data[1];
+  const char *nextSensorName = track[data[1]].name;
   int nextSensorTick = data[2];
   int timeDiff = data[3];
   int distDiff = data[4];
@@ -270,6 +362,9 @@ void displayServer() {
   trainDisplayInit(trainCursor);
 
   Cursor invalidCmdCursor{23, 1};
+
+  // shared by the stack, period and budget reports
+  Cursor reportCursor{33, 1};
 #endif
 
   bool quit = false;
@@ -295,7 +390,7 @@ void displayServer() {
         renderTime(timeCursor, msg.data);
         break;
       case Predict:
-        renderPredict(predictCursor, msg.data);
+        renderPredict(predictCursor, msg.data, track);
         break;
       case Train:
         renderTrain(trainCursor, msg.data, track);
@@ -306,6 +401,18 @@ void displayServer() {
       case InvalidCmd:
         renderInvalidCmd(invalidCmdCursor, msg.data[0]);
         break;
+      case StackReport:
+        renderStackReport(reportCursor, msg.data);
+        break;
+      case PeriodReport:
+        renderPeriodReport(reportCursor, msg.data);
+        break;
+      case BudgetReport:
+        renderBudgetReport(reportCursor, msg.data);
+        break;
+      case ProfileDump:
+        renderProfileDump(msg.data);
+        break;
       case Quit:
         quit = true;
         break;
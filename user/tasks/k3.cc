@@ -1,7 +1,7 @@
 #include "k3.h"
 
 #include "clock_server.h"
-#include "kern/arch/ts7200.h"
+#include "kern/arch.h"
 #include "kern/sys.h"
 #include "lib/io.h"
 #include "name_server.h"
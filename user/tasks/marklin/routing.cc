@@ -21,19 +21,27 @@ void runRouting() {
   routing.run();
 }
 
-void awaitStop() {
-  int senderTid;
-  int data[5];
-  receive(senderTid, data);
-  reply(senderTid);
-
-  int delay = data[0];
-  int worldTid = data[1];
-  int trainId = data[2];
-  bool rerouteOnSlow = data[3];
-  bool rerouteOnStop = data[4];
-
-  clock::delay(delay);
+struct StopArgs {
+  int clockServer;
+  int timer;
+  int worldTid;
+  int trainId;
+  bool rerouteOnSlow;
+  bool rerouteOnStop;
+};
+
+void awaitStop(const StopArgs* args) {
+  int clockServer = args->clockServer;
+  int timer = args->timer;
+  int worldTid = args->worldTid;
+  int trainId = args->trainId;
+  bool rerouteOnSlow = args->rerouteOnSlow;
+  bool rerouteOnStop = args->rerouteOnStop;
+
+  if (timerWait(clockServer, timer) < 0) {
+    // cancelled; the train has been given another stop
+    return;
+  }
   if (rerouteOnSlow) {
     log("[routing]: reroute before stop train %d", trainId);
     send(worldTid, marklin::Msg{marklin::Msg::Action::Reroute, {trainId}, 1});
@@ -49,6 +57,7 @@ void awaitStop() {
 
 Routing::Routing() : worldTid{0} {
   reservationServer = whoIs(RESERVATION_SERVER_NAME);
+  clockServer = whoIs(CLOCK_SERVER_NAME);
   registerAs(ROUTING_SERVER_NAME);
   receive(worldTid, trackSet);
   reply(worldTid);
@@ -60,6 +69,7 @@ Routing::Routing() : worldTid{0} {
   for (int i = 0; i < 80; ++i) {
     trainStopSensor[i][0] = -1;
     trainStopSensor[i][1] = -1;
+    pendingStops[i].timer = -1;
   }
 }
 
@@ -70,16 +80,42 @@ void Routing::clearStatus() {
 }
 
 void Routing::updateTrainLoc(int trainId, track_node* dest, int offset) {
-  send(worldTid, Msg{Msg::Action::Depart, {trainId, dest - track, offset}, 3});
+  send(worldTid, Msg{Msg::Action::Depart, {trainId, (int)(dest - track), offset}, 3});
 }
 
 void Routing::handleDeparture(int trainId, int speed, int delay,
                               bool rerouteOnSlow, bool rerouteOnStop) {
   send(worldTid, Msg::tr(speed, trainId));
-  int tid = create(1, awaitStop);
+  scheduleStop(trainId, delay, rerouteOnSlow, rerouteOnStop);
+}
+
+void Routing::scheduleStop(int trainId, int delay, bool rerouteOnSlow,
+                           bool rerouteOnStop) {
+  PendingStop& pending = pendingStops[trainId];
+  // a stop of the same kind is only moved, keeping the task waiting on it
+  if (pending.timer >= 0 && pending.rerouteOnSlow == rerouteOnSlow &&
+      pending.rerouteOnStop == rerouteOnStop &&
+      timerReschedule(clockServer, pending.timer, delay) == 0) {
+    return;
+  }
+  cancelStop(trainId);
+  pending = PendingStop{timerStart(clockServer, delay), rerouteOnSlow,
+                        rerouteOnStop};
+  assert(pending.timer >= 0);
+  int tid = create(1, awaitStop,
+                   StopArgs{clockServer, pending.timer, worldTid, trainId,
+                            rerouteOnSlow, rerouteOnStop},
+                   STACK_TINY);
   assert(tid >= 0);
-  int data[5]{delay, worldTid, trainId, rerouteOnSlow, rerouteOnStop};
-  send(tid, data);
+}
+
+void Routing::cancelStop(int trainId) {
+  PendingStop& pending = pendingStops[trainId];
+  if (pending.timer >= 0) {
+    // fails if it has already fired
+    timerCancel(clockServer, pending.timer);
+    pending.timer = -1;
+  }
 }
 
 void Routing::setTrainBlocked(int trainId, bool blocked) {
@@ -208,7 +244,8 @@ void Routing::onDestinationSet(int* data) {
           "cruiseDist: %d",
           realDist, accelDist, stopDist, realDist - accelDist - stopDist);
     } else {
-      // has sensor in between
+      // has sensor in between; the stop is timed from the sensor
+      cancelStop(trainId);
       trainStopSensor[trainId][0] = stopSensor->num;
       trainStopSensor[trainId][1] = stopDelayDist * 100 / velocity;
       trainStopSensor[trainId][2] = blockedSensor != nullptr;
@@ -548,6 +585,7 @@ void Routing::handleReroute(int* data) {
       // has sensor in between
       log("[reroute]: reroute train %d, stop sensor %s", trainId,
           stopSensor->name);
+      cancelStop(trainId);
       trainStopSensor[trainId][0] = stopSensor->num;
       trainStopSensor[trainId][1] = stopDelayDist * 100 / velocity;
       trainStopSensor[trainId][2] = blockedSensor != nullptr;
@@ -568,7 +606,12 @@ void Routing::run() {
         break;
       case Msg::Action::Reroute: {
         log("[reroute]: received reroute train %d", msg.data[0]);
+        // the train is about to stop short; get ahead of the display and
+        // reservation traffic at our own priority until it has a new path
+        int tid = myTid();
+        int priority = setPriority(tid, ROUTING_REROUTE_PRIORITY);
         handleReroute(msg.data);
+        setPriority(tid, priority);
         break;
       }
       case marklin::Msg::Action::SensorTriggered: {
@@ -578,10 +621,7 @@ void Routing::run() {
         int stopDelay = trainStopSensor[trainId][1];
         bool reroute = trainStopSensor[trainId][2];
         if (awaitSensor == sensorNum) {
-          int tid = create(1, awaitStop);
-          assert(tid >= 0);
-          int data[5]{stopDelay, worldTid, trainId, reroute, false};
-          send(tid, data);
+          scheduleStop(trainId, stopDelay, reroute, false);
           trainStopSensor[trainId][0] = -1;
           trainStopSensor[trainId][1] = -1;
           trainStopSensor[trainId][2] = -1;
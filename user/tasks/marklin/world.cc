@@ -77,6 +77,8 @@ void World::run() {
       case Msg::Action::TrainStopped:
         onTrainStop(getTrain(msg.data[0]));
         break;
+      default:
+        break;
     }
   }
 }
@@ -148,7 +150,7 @@ void World::onSetTrainLoc(const Msg &msg) {
   // clang-format off
   send(displayServerTid, view::Msg{
     view::Action::Train, {
-      t - trains, view::TrainStatus::Stationary,
+      (int)(t - trains), view::TrainStatus::Stationary,
       t->locNodeIdx, t->locOffset,
       t->viaNodeIdx, t->viaOffset,
       t->destNodeIdx, t->destOffset,
@@ -156,7 +158,7 @@ void World::onSetTrainLoc(const Msg &msg) {
   });
   send(displayServerTid,
        view::Msg{view::Action::Predict,
-                 {t->id, (int)t->nextSensor->name, t->nextSensorTick, 0, 0, 0},
+                 {t->id, (int)(t->nextSensor - track), t->nextSensorTick, 0, 0, 0},
                  6});
   // clang-format on
 }
@@ -194,7 +196,7 @@ void World::onSensorTrigger(const Msg &msg) {
     send(marklinServerTid, Msg::stop());
     send(displayServerTid,
          view::Msg{view::Action::Predict,
-                   {-1, (int)track[sensorNum].name, 0, 0, 0, 0},
+                   {-1, sensorNum, 0, 0, 0, 0},
                    6});
     return;
   }
@@ -210,7 +212,7 @@ void World::onSensorTrigger(const Msg &msg) {
       send(marklinServerTid, Msg::stop());
       send(displayServerTid,
            view::Msg{view::Action::Predict,
-                     {-2, (int)track[sensorNum].name, 0, 0, 0, 0},
+                     {-2, sensorNum, 0, 0, 0, 0},
                      6});
       return;
     }
@@ -224,7 +226,7 @@ void World::onSensorTrigger(const Msg &msg) {
     send(marklinServerTid, Msg::stop());
     send(displayServerTid,
          view::Msg{view::Action::Predict,
-                   {-3, (int)track[sensorNum].name, 0, 0, 0, 0},
+                   {-3, sensorNum, 0, 0, 0, 0},
                    6});
     return;
   }
@@ -268,7 +270,7 @@ void World::onSensorTrigger(const Msg &msg) {
   // clang-format off
   send(displayServerTid, view::Msg{
     view::Action::Train, {
-      t - trains, view::TrainStatus::PassedSensor,
+      (int)(t - trains), view::TrainStatus::PassedSensor,
       sensorNum, 0,
       t->viaNodeIdx, t->viaOffset,
       t->destNodeIdx, t->destOffset,
@@ -276,7 +278,7 @@ void World::onSensorTrigger(const Msg &msg) {
   });
   send(displayServerTid,
        view::Msg{view::Action::Predict,
-                 {t->id, (int)t->nextSensor->name, t->nextSensorTick, timeDiff,
+                 {t->id, (int)(t->nextSensor - track), t->nextSensorTick, timeDiff,
                   distDiff, avgVelocity},
                  6});
   // clang-format on
@@ -327,7 +329,6 @@ int World::onSetTrainSpeed(int senderTid, const Msg &msg) {
     // }
 
     int speed = cmd & SPEED_MASK;
-    int light = cmd & LIGHT_MASK;
 
     if (speed == 15) {
       // ignore reverse command in the form of tr command
@@ -376,7 +377,7 @@ int World::onReverseTrain(const Msg &msg) {
     // clang-format off
     send(displayServerTid, view::Msg{
       view::Action::Train, {
-        train - trains,
+        (int)(train - trains),
         train->isBlocked ? view::TrainStatus::Blocked : view::TrainStatus::Stationary,
         train->locNodeIdx, train->locOffset,
         train->viaNodeIdx, train->viaOffset,
@@ -385,7 +386,7 @@ int World::onReverseTrain(const Msg &msg) {
     });
     send(displayServerTid,
          view::Msg{view::Action::Predict,
-                   {train->id, (int)train->nextSensor->name, 0, 0, 0, 0},
+                   {train->id, (int)(train->nextSensor - track), 0, 0, 0, 0},
                    6});
     // clang-format on
   }
@@ -398,7 +399,7 @@ void World::onTrainDepart(const Msg &msg) {
   // clang-format off
   send(displayServerTid, view::Msg{
     view::Action::Train, {
-      train - trains, view::TrainStatus::Departed,
+      (int)(train - trains), view::TrainStatus::Departed,
       train->locNodeIdx, train->locOffset,
       train->viaNodeIdx, train->viaOffset,
       train->destNodeIdx, train->destOffset,
@@ -419,7 +420,7 @@ void World::onTrainStop(Train *train) {
     // clang-format off
     send(displayServerTid, view::Msg{
       view::Action::Train, {
-        train - trains,
+        (int)(train - trains),
         view::TrainStatus::Stationary,
         train->locNodeIdx, train->locOffset,
         train->viaNodeIdx, train->viaOffset,
@@ -462,6 +463,7 @@ bool World::manualDepartReserve(Train *train) {
       }
     }
   }
+  return dist >= train->getStopDist();
 }
 
 Train *World::predictTrainBySensor(int sensorNum, int &offDist) {
@@ -8,6 +8,7 @@
 #include "marklin/world.h"
 #include "name_server.h"
 #include "user/message.h"
+#include "user/sleep.h"
 #include "user/task.h"
 
 namespace marklin {
@@ -56,8 +57,9 @@ void swNotifier() {
   int serverTid = whoIs(MARKLIN_SERVER_NAME);
   Msg swReadyMsg{Msg::Action::SwitchReady, {}, 0};
 
+  setPeriod(15, 15);
   while (true) {
-    clock::delay(15);
+    waitNextPeriod();
     send(serverTid, swReadyMsg);
   }
 }
@@ -68,7 +70,11 @@ void querySensors() {
   int marklinServerTid = whoIs(MARKLIN_SERVER_NAME);
   int displayServerTid = whoIs(DISPLAY_SERVER_NAME);
   int worldTid = whoIs(WORLD_NAME);
+  // a query takes about 50 ms at 2400 baud; only monitor that it stays under
+  // 100 ms
+  setPeriod(0, 10);
   while (true) {
+    waitNextPeriod();
     send(marklinServerTid, Msg::querySensors());
     bool updated = false;
     for (int i = 0; i < 10; ++i) {
@@ -120,9 +126,9 @@ void querySensors() {
 void cmdServer() {
   registerAs(MARKLIN_SERVER_NAME);
 
-  int cmdDelegateTid = create(1, cmdDelegate);
-  int swNotifierTid = create(1, swNotifier);
-  int queryTid = create(1, querySensors);
+  int cmdDelegateTid = create(1, cmdDelegate, STACK_TINY);
+  int swNotifierTid = create(1, swNotifier, STACK_TINY);
+  create(1, querySensors, STACK_SMALL);
 
   int senderTid;
   Msg msg;
@@ -158,6 +164,8 @@ void cmdServer() {
         swQueue.enqueue(msg);
         reply(senderTid, 0);
         break;
+      default:
+        break;
     }
 
     if (cmdCanSend) {
@@ -65,3 +65,19 @@ int whoIs(const char *name) {
   int status = send(NAME_SERVER_TID, msg, reply);
   return status >= 0 ? reply : -1;
 }
+
+/**
+ * @brief get tid from name on the peer kernel, through the gateway (see
+ * remote.h)
+ *
+ * @param name at most 30 characters
+ * @return the tid with REMOTE_TID_FLAG set, -1 if not found
+ */
+int remoteWhoIs(const char *name) {
+  char msg[36];
+  int reply = -1;
+  msg[0] = MSG_WHO;
+  strCopy(name, msg + 1, MSG_LEN - 1);
+  int status = send(remoteTid(NAME_SERVER_TID), msg, reply);
+  return status >= 0 && reply >= 0 ? remoteTid(reply) : -1;
+}
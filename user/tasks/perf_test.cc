@@ -1,10 +1,22 @@
 #include "perf_test.h"
 
+#include "clock_server.h"
+#include "k3.h"
+#include "kern/syscall_code.h"
+#include "kern/tick_page.h"
 #include "lib/assert.h"
 #include "lib/io.h"
+#include "lib/string.h"
 #include "lib/timer.h"
+#include "name_server.h"
+#include "remote.h"
+#include "user/event.h"
 #include "user/message.h"
+#include "user/sleep.h"
+#include "user/sys.h"
 #include "user/task.h"
+#include "user/uart.h"
+#include "track_data.h"
 
 #define TEN(e) \
   e;           \
@@ -20,8 +32,72 @@
 #define HUNDRED(e) TEN(TEN(e))
 #define THOUSAND(e) HUNDRED(TEN(e))
 
+#define SCREEN_ROWS 24
+#define SCREEN_COLS 80
+#define SCREEN_REFRESHES 50
+
+#define SLEEP_SAMPLES 500
+
+#define PERIODIC_TICKS 2
+#define PERIODIC_WAITS 40
+// as many subscriptions as the clock server holds
+#define PERIODIC_LEAKERS 16
+
+#define TIMER_HANDLES 16
+
+#define SETPRIO_BUDGET_US 1000
+#define SETPRIO_BUDGET_PERIOD 5
+
+#define SPAWNS 1000
+
+#define YIELDS 1000
+
+#define CHURNS 5000
+
+#define CHURN_BACKGROUND 200
+
+#define LATENCY_SAMPLES 200
+
+#define SCHED_TEST_TICKS 1000
+#define SCHED_CALIBRATION_TICKS 20
+
+#define REMOTE_SAMPLES 200
+#define REMOTE_BULK 200
+#define REMOTE_ECHO_NAME "REMOTE_ECHO"
+
+#define ROUTING_ROUTES 2000
+#define ROUTING_WORKERS 16
+#define ROUTING_PAR_ROUTES 16000  // split evenly among the workers
+
+#define BENCH_ITERATIONS 1000
+#define BENCH_WAKE_SAMPLES 200
+#define BENCH_PUTC_BYTES 16384
+#define BENCH_MAX_MSG 256
+#define BENCH_DELAY_US 2500  // a tick and a half
+
 namespace perf_test {
 
+#if ENABLE_OPT
+const char opt[] = "opt";
+#else
+const char opt[] = "noopt";
+#endif
+
+#if ENABLE_CACHE
+const char cch[] = "cache";
+#else
+const char cch[] = "nocache";
+#endif
+
+#if ENABLE_ICACHE_LOCK
+const char lck[] = "lock";
+#else
+const char lck[] = "nolock";
+#endif
+
+int instance = 0;
+unsigned int seed = 1;
+
 unsigned int timerOverhead;
 
 void timerTest() {
@@ -41,18 +117,6 @@ void sender() {
   }
   int receiverTid = 3;
 
-#if ENABLE_OPT
-  char opt[] = "opt";
-#else
-  char opt[] = "noopt";
-#endif
-
-#if ENABLE_CACHE
-  char cch[] = "cache";
-#else
-  char cch[] = "nocache";
-#endif
-
 #if SENDER_FIRST
   char mode = 'S';
 #else
@@ -66,7 +130,8 @@ void sender() {
     THOUSAND(send(receiverTid, msg, size, reply, size));
     unsigned int t1 = timer::getTick(TIMER3_BASE);
     (void)reply;
-    println(COM2, "%s %s %c %d %d", opt, cch, mode, size, (t0 - t1) / 508);
+    println(COM2, "%s %s %c %d %d", opt, cch, mode, size,
+            (t0 - t1) / (TIMER3_FRQ / 1000));
   }
 }
 
@@ -85,6 +150,968 @@ void receiver() {
   }
 }
 
+unsigned int timestamp() {
+  int tick;
+  unsigned int subTick;
+  clock::now(tick, subTick);
+  return (unsigned int)tick * TICK_TIMER_LOAD + subTick;
+}
+
+// TIMER3 counts taken by iterations runs, in nanoseconds per run
+unsigned int nsPerRun(unsigned int counts, int iterations) {
+  return counts * 1000 / (TIMER3_FRQ / 1000) * 1000 / iterations;
+}
+
+/**
+ * @brief redraw a full screen on COM2 repeatedly and report the sustained
+ * throughput in bytes per second, timed until the send buffer has drained
+ */
+void uartThroughput() {
+  char screen[SCREEN_ROWS * SCREEN_COLS];
+  for (int i = 0; i < SCREEN_ROWS * SCREEN_COLS; ++i) {
+    screen[i] = 'A' + i % 26;
+    if (i % SCREEN_COLS == SCREEN_COLS - 2) {
+      screen[i] = '\n';
+    } else if (i % SCREEN_COLS == SCREEN_COLS - 1) {
+      screen[i] = '\r';
+    }
+  }
+  int bytes = 0;
+  uartFlush(COM2);
+  unsigned int t0 = timestamp();
+  for (int i = 0; i < SCREEN_REFRESHES; ++i) {
+    bytes += putstr(COM2, "\033[H");
+    bytes += uartWrite(COM2, screen, sizeof(screen));
+  }
+  uartFlush(COM2);
+  unsigned int us = (timestamp() - t0) * 1000 / (TIMER3_FRQ / 1000);
+  println(COM2, "\033[2J%s %s uart %d %u", opt, cch, bytes,
+          (unsigned int)(bytes * 1000000ULL / (us ? us : 1)));
+}
+
+// TIMER3 counts since the start of the current tick
+unsigned int sinceTick() {
+  int tick;
+  unsigned int subTick;
+  clock::now(tick, subTick);
+  return subTick;
+}
+
+/**
+ * @brief sleep for one tick repeatedly and report how long after the tick
+ * interrupt the sleeper gets to run, as min/avg/max in microseconds
+ */
+void sleepLatency() {
+  unsigned int minLatency = -1, maxLatency = 0, totalLatency = 0;
+  for (int i = 0; i < SLEEP_SAMPLES; ++i) {
+    sleepFor(1);
+    unsigned int latency = sinceTick();
+    minLatency = latency < minLatency ? latency : minLatency;
+    maxLatency = latency > maxLatency ? latency : maxLatency;
+    totalLatency += latency;
+  }
+  println(COM2, "%s %s sleep %u %u %u", opt, cch,
+          minLatency * 1000 / (TIMER3_FRQ / 1000),
+          totalLatency / SLEEP_SAMPLES * 1000 / (TIMER3_FRQ / 1000),
+          maxLatency * 1000 / (TIMER3_FRQ / 1000));
+}
+
+int sleepersWakeTick;
+int sleepersWoken;
+
+void sleeper() {
+  if (sleepUntil(sleepersWakeTick) == sleepersWakeTick) {
+    ++sleepersWoken;
+  }
+}
+
+/**
+ * @brief put as many tasks to sleep on the same tick as the kernel allows and
+ * report how many were created and how many woke up on time
+ */
+void maxSleepers() {
+  sleepersWakeTick = clock::time() + 100;
+  sleepersWoken = 0;
+  int created = 0;
+  while (create(1, sleeper, STACK_TINY) >= 0) {
+    ++created;
+  }
+  sleepUntil(sleepersWakeTick + 1);
+  println(COM2, "%s %s sleepers %d %d", opt, cch, created, sleepersWoken);
+}
+
+struct SpawnArgs {
+  int data[5];
+};
+
+void spawnReceiveArgs() {
+  int parentTid;
+  SpawnArgs args;
+  receive(parentTid, args);
+  reply(parentTid);
+}
+
+void spawnWithArgs(const SpawnArgs *args) { (void)args; }
+
+/**
+ * @brief spawn 1000 short-lived tasks that need 20 bytes of arguments, once
+ * with create() + send() and once with createArgs(), and report the time
+ * per spawn in nanoseconds for both
+ */
+void createTest() {
+  SpawnArgs args{{1, 2, 3, 4, 5}};
+
+  unsigned int t0 = timestamp();
+  for (int i = 0; i < SPAWNS; ++i) {
+    int tid = create(0, spawnReceiveArgs, STACK_TINY);
+    send(tid, args);
+  }
+  unsigned int t1 = timestamp();
+  for (int i = 0; i < SPAWNS; ++i) {
+    create(0, spawnWithArgs, args, STACK_TINY);
+  }
+  unsigned int t2 = timestamp();
+
+  println(COM2, "%s %s spawn send %u", opt, cch, nsPerRun(t1 - t0, SPAWNS));
+  println(COM2, "%s %s spawn args %u", opt, cch, nsPerRun(t2 - t1, SPAWNS));
+}
+
+int yieldStartTick;
+int yieldersDone;
+unsigned int yieldStart;
+unsigned int yieldEnd;
+
+void yielder() {
+  // start together on one tick so all yielders share one ready queue
+  sleepUntil(yieldStartTick);
+  if (!yieldStart) {
+    yieldStart = timestamp();
+  }
+  THOUSAND(yield());
+  yieldEnd = timestamp();
+  ++yieldersDone;
+}
+
+/**
+ * @brief round-robin 2, 8 and 32 tasks at priority 0 that each yield 1000
+ * times, and report the time per context switch in nanoseconds
+ *
+ * With more tasks each switch touches descriptors that are further apart, so
+ * the growth from 2 to 32 tasks shows the cache cost of the descriptor layout.
+ * Must be called from a task with a priority lower than 0.
+ */
+void yieldTest() {
+  const int numYielders[] = {2, 8, 32};
+  for (int n : numYielders) {
+    yieldersDone = 0;
+    yieldStart = yieldEnd = 0;
+    yieldStartTick = clock::time() + 2;
+    for (int i = 0; i < n; ++i) {
+      create(0, yielder, STACK_TINY);
+    }
+    while (yieldersDone < n) {
+      sleepFor(1);
+    }
+    unsigned int switches = n * YIELDS;
+    println(COM2, "%s %s yield %d %u", opt, cch, n,
+            (yieldEnd - yieldStart) * 1000 / (TIMER3_FRQ / 1000) * 1000 /
+                switches);
+  }
+}
+
+void shortLived() {}
+
+void background() {
+  int parentTid;
+  receive(&parentTid, nullptr, 0);
+  reply(parentTid);
+}
+
+unsigned int churn() {
+  unsigned int t0 = timestamp();
+  for (int i = 0; i < CHURNS; ++i) {
+    // higher priority, so it runs to completion and its tid is recycled
+    // before the next create
+    int tid = create(0, shortLived, STACK_TINY);
+    assert(tid >= 0);
+  }
+  unsigned int t1 = timestamp();
+  return nsPerRun(t1 - t0, CHURNS);
+}
+
+/**
+ * @brief create and destroy 5000 short-lived tasks, first alone and then with
+ * 200 other tasks alive, and report the time per create/destroy pair in
+ * nanoseconds
+ *
+ * Every create takes a tid from the pool and every destroy returns it with the
+ * next generation, so both numbers should match if tid handling is O(1).
+ */
+void churnTest() {
+  unsigned int alone = churn();
+
+  int tids[CHURN_BACKGROUND];
+  for (int i = 0; i < CHURN_BACKGROUND; ++i) {
+    tids[i] = create(0, background, STACK_TINY);
+    assert(tids[i] >= 0);
+  }
+  unsigned int crowded = churn();
+  for (int i = 0; i < CHURN_BACKGROUND; ++i) {
+    send(tids[i], nullptr, 0, nullptr, 0);
+  }
+
+  println(COM2, "%s %s churn %d %u %u", opt, cch, CHURNS, alone, crowded);
+}
+
+bool loadRunning;
+
+/**
+ * @brief stand-in for routing: rebuilding the track data runs through tens of
+ * KB of straight-line code and a few KB of data, evicting the kernel from the
+ * caches
+ */
+void routingLoad() {
+  track_node track[TRACK_MAX];
+  while (loadRunning) {
+    init_tracka(track);
+  }
+}
+
+/**
+ * @brief shortest distance in um, the unit of the track data, from node src to
+ * node dest, by the same
+ * O(n^2) Dijkstra as Routing::route but without reservations
+ *
+ * @return the distance, __INT_MAX__ if dest cannot be reached
+ */
+int shortestDist(const track_node *track, int size, int src, int dest) {
+  int dist[TRACK_MAX];
+  bool done[TRACK_MAX];
+  for (int i = 0; i < size; ++i) {
+    dist[i] = __INT_MAX__;
+    done[i] = false;
+  }
+  dist[src] = 0;
+  while (true) {
+    int cur = -1;
+    for (int i = 0; i < size; ++i) {
+      if (!done[i] && dist[i] < __INT_MAX__ &&
+          (cur < 0 || dist[i] < dist[cur])) {
+        cur = i;
+      }
+    }
+    if (cur < 0 || cur == dest) {
+      break;
+    }
+    done[cur] = true;
+    int edges = track[cur].type == NODE_BRANCH ? 2 : 1;
+    for (int i = 0; i < edges; ++i) {
+      const track_edge &edge = track[cur].edge[i];
+      if (!edge.dest) {
+        continue;
+      }
+      int next = edge.dest - track;
+      if (dist[cur] + edge.dist < dist[next]) {
+        dist[next] = dist[cur] + edge.dist;
+      }
+    }
+  }
+  return dist[dest];
+}
+
+track_node routingTrack[TRACK_MAX];
+
+/**
+ * @brief route between routes node pairs of routingTrack drawn from state
+ *
+ * @return the total distance of the reachable routes in mm
+ */
+unsigned int routeRandom(int size, int routes, unsigned int state) {
+  unsigned int total = 0;
+  for (int i = 0; i < routes; ++i) {
+    // the high bits of a linear congruential generator
+    state = state * 1103515245 + 12345;
+    int src = (state >> 16) % size;
+    state = state * 1103515245 + 12345;
+    int dest = (state >> 16) % size;
+    int dist = shortestDist(routingTrack, size, src, dest);
+    if (dist != __INT_MAX__) {
+      total += dist / 1000;
+    }
+  }
+  return total;
+}
+
+/**
+ * @brief route between ROUTING_ROUTES node pairs of track A drawn from seed,
+ * and report the time per route in ns, the total distance of the reachable
+ * routes in mm, which only depends on the seed, and the seed
+ *
+ * Only computation, no sleeping or I/O, so it is the workload for scaling
+ * runs and seeded sweeps on the host.
+ */
+void routingTest() {
+  int size = init_tracka(routingTrack);
+  unsigned int t0 = timestamp();
+  unsigned int total = routeRandom(size, ROUTING_ROUTES, seed);
+  unsigned int t1 = timestamp();
+  println(COM2, "%s %s routing %d %u %u %u", opt, cch, ROUTING_ROUTES,
+          nsPerRun(t1 - t0, ROUTING_ROUTES), total, seed);
+}
+
+struct RoutingArgs {
+  int size;
+  unsigned int state;
+};
+
+void routingWorker(const RoutingArgs *args) {
+  unsigned int total = routeRandom(args->size,
+                                   ROUTING_PAR_ROUTES / ROUTING_WORKERS,
+                                   args->state);
+  send(myParentTid(), total);
+}
+
+/**
+ * @brief split ROUTING_PAR_ROUTES routes among ROUTING_WORKERS tasks, each
+ * drawing its own node pairs from seed, and report the workers, the routes,
+ * the wall time per route in ns, the total distance in mm and the seed
+ *
+ * The total does not depend on the number of cores, the time per route
+ * should fall with it (see host -threads).
+ */
+void routingParallelTest() {
+  int size = init_tracka(routingTrack);
+  unsigned int t0 = timestamp();
+  for (int i = 0; i < ROUTING_WORKERS; ++i) {
+    create(2, routingWorker, RoutingArgs{size, seed * ROUTING_WORKERS + i},
+           STACK_SMALL);
+  }
+  unsigned int total = 0;
+  for (int i = 0; i < ROUTING_WORKERS; ++i) {
+    int tid;
+    unsigned int part;
+    receive(tid, part);
+    reply(tid);
+    total += part;
+  }
+  unsigned int t1 = timestamp();
+  println(COM2, "%s %s routing par %d %d %u %u %u", opt, cch, ROUTING_WORKERS,
+          ROUTING_PAR_ROUTES, nsPerRun(t1 - t0, ROUTING_PAR_ROUTES), total,
+          seed);
+}
+
+void echo() {
+  int senderTid;
+  int msg;
+  while (true) {
+    receive(senderTid, msg);
+    reply(senderTid, msg);
+    if (msg < 0) {
+      break;
+    }
+  }
+}
+
+struct LatencyStats {
+  unsigned int count, min, max, total;
+  unsigned long long totalSq;
+
+  LatencyStats()
+      : count{0}, min{(unsigned int)-1}, max{0}, total{0}, totalSq{0} {}
+
+  void add(unsigned int counts) {
+    unsigned int us = counts * 1000 / (TIMER3_FRQ / 1000);
+    ++count;
+    min = us < min ? us : min;
+    max = us > max ? us : max;
+    total += us;
+    totalSq += (unsigned long long)us * us;
+  }
+
+  void print(const char *name) const {
+    unsigned int avg = total / count;
+    // the variance is at most max * max, so it fits once divided down
+    unsigned int variance =
+        (unsigned int)(totalSq / count - (unsigned long long)avg * avg);
+    println(COM2, "%s %s %s %s %u %u %u %u", opt, cch, lck, name, min, avg,
+            max, variance);
+  }
+};
+
+/**
+ * @brief measure single SRR round trips and tick interrupt latency while a
+ * lower priority task keeps the caches busy, and report min/avg/max/variance
+ * in microseconds (variance in square microseconds)
+ *
+ * Every sample sleeps for a tick first so that the load runs in between. Build
+ * with and without ENABLE_ICACHE_LOCK to compare; must be called from a task
+ * with a priority higher than 6.
+ */
+void latencyTest() {
+  loadRunning = true;
+  create(6, routingLoad);
+  int echoTid = create(1, echo, STACK_TINY);
+
+  LatencyStats srr, irq;
+  while (srr.count < LATENCY_SAMPLES) {
+    sleepFor(1);
+    irq.add(sinceTick());
+
+    sleepFor(1);
+    int msg = 0, rply;
+    // TIMER3 may be reloaded in between, so not a plain counter difference
+    unsigned int t0 = timestamp();
+    send(echoTid, msg, rply);
+    srr.add(timestamp() - t0);
+  }
+  loadRunning = false;
+  int stop = -1, rply;
+  send(echoTid, stop, rply);
+
+  srr.print("srr");
+  irq.print("irq");
+}
+
+int spinsPerMs;
+
+void spin(int ms) {
+  for (volatile int i = 0; i < ms * spinsPerMs; ++i) {
+  }
+}
+
+/**
+ * @brief set spinsPerMs from SCHED_CALIBRATION_TICKS ticks of the spin loop,
+ * starting on a tick boundary, so the tick interrupts that land in the loop
+ * are counted and the timer granularity averages out
+ */
+void calibrateSpin() {
+  spinsPerMs = 10000;
+  int start = clock::time();
+  while (clock::time() == start) {
+  }
+  unsigned long long spins = 0;
+  unsigned int t0 = timestamp();
+  unsigned int elapsed;
+  do {
+    spin(1);
+    spins += spinsPerMs;
+    elapsed = timestamp() - t0;
+  } while (elapsed < SCHED_CALIBRATION_TICKS * TICK_TIMER_LOAD);
+  spinsPerMs = (int)(spins * (TIMER3_FRQ / 1000) / elapsed);
+}
+
+unsigned int countsToUs(unsigned int counts) {
+  return counts * 1000 / (TIMER3_FRQ / 1000);
+}
+
+struct SchedTask {
+  int period;    // ticks
+  int deadline;  // ticks
+  int cost;      // ms of cpu per job
+  int priority;  // under fixed priority, rate monotonic
+};
+
+// our periodic tasks (sensor poll, stats, switch notifier) with the load of
+// each job scaled up so that the total utilization is 0.93
+const SchedTask schedTasks[] = {
+    {7, 7, 30, 3},
+    {10, 10, 30, 4},
+    {15, 15, 30, 5},
+};
+const int numSchedTasks = sizeof(schedTasks) / sizeof(SchedTask);
+
+struct SchedArgs {
+  SchedTask task;
+  int index;
+  bool edf;
+  int startTick;
+};
+
+int schedJobs, schedMisses, schedDone;
+unsigned int schedWorst[numSchedTasks];  // worst response per task, counts
+
+void schedWorker(const SchedArgs *args) {
+  SchedArgs a = *args;
+  sleepUntil(a.startTick);
+  setPeriod(a.task.period, a.task.deadline);
+  if (a.edf) {
+    setSchedClass(SCHED_EDF);
+  }
+  while (clock::time() < a.startTick + SCHED_TEST_TICKS) {
+    spin(a.task.cost);
+    waitNextPeriod();
+  }
+  int tid = myTid();
+  PeriodStats stats;
+  int ret;
+  for (int i = 0; (ret = periodStats(i, &stats)) != -2; ++i) {
+    // an empty slot leaves stats untouched
+    if (ret == 0 && stats.tid == tid) {
+      schedJobs += stats.jobs;
+      schedMisses += stats.misses;
+      schedWorst[a.index] = stats.worstResponse;
+    }
+  }
+  ++schedDone;
+}
+
+void runSchedTasks(bool edf) {
+  schedJobs = schedMisses = schedDone = 0;
+  int startTick = clock::time() + 2;
+  for (int i = 0; i < numSchedTasks; ++i) {
+    // under EDF all tasks share one level and only deadlines decide
+    SchedArgs args{schedTasks[i], i, edf, startTick};
+    create(edf ? 4 : schedTasks[i].priority, schedWorker, args, STACK_TINY);
+  }
+  while (schedDone < numSchedTasks) {
+    sleepFor(10);
+  }
+  println(COM2, "%s %s sched %s %d %d worst %u %u %u", opt, cch,
+          edf ? "edf" : "fixed", schedJobs, schedMisses,
+          countsToUs(schedWorst[0]), countsToUs(schedWorst[1]),
+          countsToUs(schedWorst[2]));
+}
+
+/**
+ * @brief run the same periodic task set for 10 s under rate-monotonic fixed
+ * priorities and under EDF
+ *
+ * Prints the measured cost of a job in us and the resulting utilization in
+ * per mille, then the jobs, deadline misses and worst response time in us of
+ * each task for both runs. Whether anything misses depends on that measured
+ * utilization and on the load the rest of the system adds. Must be called
+ * from a task with a priority higher than 3.
+ */
+void edfTest() {
+  calibrateSpin();
+  unsigned int t0 = timestamp();
+  spin(schedTasks[0].cost);
+  unsigned int costUs = countsToUs(timestamp() - t0);
+  unsigned int utilization = 0;
+  for (const SchedTask &task : schedTasks) {
+    // us of cpu per ms of period is per mille
+    utilization += costUs / (task.period * TICK_MS);
+  }
+  println(COM2, "%s %s sched cost %u util %u", opt, cch, costUs, utilization);
+
+  runSchedTasks(false);
+  runSchedTasks(true);
+}
+
+int periodicSubscribed;
+
+// subscribe and exit without cancelling
+void periodicLeaker() {
+  if (periodic(whoIs(CLOCK_SERVER_NAME), PERIODIC_TICKS) == 0) {
+    ++periodicSubscribed;
+  }
+}
+
+/**
+ * @brief wait on a 2-tick clock server subscription, oversleeping 5 ticks
+ * before every 10th wait, and report the waits and the releases they missed
+ * (2 per oversleep); then fill every subscription slot with tasks that exit
+ * without cancelling, and report how many of them could subscribe again a
+ * period later, all of them once the server frees the leaked slots
+ */
+void periodicTest() {
+  int clockTid = whoIs(CLOCK_SERVER_NAME);
+  int missed = 0;
+  int ret = periodic(clockTid, PERIODIC_TICKS);
+  assert(ret == 0);
+  for (int i = 0; i < PERIODIC_WAITS; ++i) {
+    if (i % 10 == 9) {
+      sleepFor(5);
+    }
+    missed += waitPeriod(clockTid);
+  }
+  periodic(clockTid, 0);
+
+  // every slot taken before has come due, with a tick for the clock server to
+  // catch up with the kernel's sleep
+  sleepFor(PERIODIC_TICKS + 2);
+  for (int round = 0; round < 2; ++round) {
+    periodicSubscribed = 0;
+    for (int i = 0; i < PERIODIC_LEAKERS; ++i) {
+      create(1, periodicLeaker, STACK_TINY);
+    }
+    sleepFor(PERIODIC_TICKS + 2);
+  }
+  println(COM2, "%s %s periodic %d %d %d", opt, cch, PERIODIC_WAITS, missed,
+          periodicSubscribed);
+}
+
+struct TimerWaitArgs {
+  int clockTid;
+  int handle;
+  int index;
+};
+
+int timerResults[TIMER_HANDLES];
+
+void timerWaiter(const TimerWaitArgs *args) {
+  timerResults[args->index] = timerWait(args->clockTid, args->handle);
+}
+
+/**
+ * @brief start TIMER_HANDLES clock server timers with a waiter each, then move
+ * half of them and cancel a quarter, and report how many fired on the tick
+ * they were last set for (allowing one tick for the request) and how many
+ * were cancelled. Must be called from a task with a priority lower than 0.
+ */
+void timerHandleTest() {
+  int clockTid = whoIs(CLOCK_SERVER_NAME);
+  int expected[TIMER_HANDLES];
+  int handles[TIMER_HANDLES];
+  int now = clock::time();
+  for (int i = 0; i < TIMER_HANDLES; ++i) {
+    handles[i] = timerStart(clockTid, 2 + i % 5);
+    assert(handles[i] >= 0);
+    expected[i] = now + 2 + i % 5;
+    create(0, timerWaiter, TimerWaitArgs{clockTid, handles[i], i},
+           STACK_TINY);
+  }
+  now = clock::time();
+  for (int i = 0; i < TIMER_HANDLES; i += 2) {
+    if (timerReschedule(clockTid, handles[i], 8 - i % 3) == 0) {
+      expected[i] = now + 8 - i % 3;
+    }
+  }
+  for (int i = 3; i < TIMER_HANDLES; i += 4) {
+    if (timerCancel(clockTid, handles[i]) == 0) {
+      expected[i] = -3;
+    }
+  }
+  sleepFor(10);
+
+  int onTime = 0, cancelled = 0;
+  for (int i = 0; i < TIMER_HANDLES; ++i) {
+    if (expected[i] == -3) {
+      cancelled += timerResults[i] == -3;
+    } else {
+      onTime += timerResults[i] == expected[i] ||
+                timerResults[i] == expected[i] + 1;
+    }
+  }
+  println(COM2, "%s %s timers %d %d", opt, cch, onTime, cancelled);
+}
+
+volatile int prioRan;
+volatile unsigned int prioSpins;
+volatile bool prioStop;
+unsigned int prioProbeSpins;
+int prioSpinnerSawProbe;
+
+void prioMark() { prioRan = 1; }
+
+void prioSendToParent() {
+  send(myParentTid(), nullptr, 0, nullptr, 0);
+  prioRan = 1;
+}
+
+void prioProbe() { prioProbeSpins = prioSpins; }
+
+void prioSpinner() {
+  while (!prioStop) {
+    ++prioSpins;
+  }
+  int parentTid;
+  receive(&parentTid, nullptr, 0);
+  prioSpinnerSawProbe = prioRan;
+  reply(parentTid);
+}
+
+bool budgetDemoted(int tid) {
+  BudgetStats stats;
+  int ret;
+  for (int i = 0; (ret = budgetStats(i, &stats)) != -2; ++i) {
+    if (ret == 0 && stats.tid == tid) {
+      return stats.demoted;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief change the priority of a ready child, a send-blocked child and a
+ * budget-throttled child, and report 1 for each that then ran in the order
+ * its new priority implies, else 0. Must be called from a task at priority 1.
+ */
+void setPriorityTest() {
+  // a ready child moves levels at once: at priority 0 it runs before
+  // setPriority returns
+  prioRan = 0;
+  int tid = create(3, prioMark, STACK_TINY);
+  int old = setPriority(tid, 0);
+  int ready = old == 3 && prioRan;
+
+  // a send-blocked child keeps waiting on us and only becomes ready, below
+  // us, when we reply
+  prioRan = 0;
+  tid = create(0, prioSendToParent, STACK_TINY);
+  old = setPriority(tid, 3);
+  int senderTid;
+  receive(&senderTid, nullptr, 0);
+  reply(senderTid);
+  int blocked = old == 0 && senderTid == tid && !prioRan;
+  sleepFor(1);
+  blocked = blocked && prioRan;
+
+  // a child throttled by its budget stays demoted below a probe at priority 4
+  // and only runs at its new priority 3, ahead of the probe, after the refill
+  prioStop = false;
+  prioSpins = 0;
+  tid = create(2, prioSpinner, STACK_TINY);
+  setBudget(tid, SETPRIO_BUDGET_US, SETPRIO_BUDGET_PERIOD);
+  // the child is only charged when it traps, so wait until it is demoted
+  while (!budgetDemoted(tid)) {
+    sleepFor(1);
+  }
+  old = setPriority(tid, 3);
+  unsigned int spins = prioSpins;
+  create(4, prioProbe, STACK_TINY);
+  sleepFor(1);
+  int throttled = old == 2 && prioProbeSpins == spins;
+  // while we sleep past the refill the child leaves its loop and waits for us
+  prioStop = true;
+  sleepFor(SETPRIO_BUDGET_PERIOD + 1);
+  prioRan = 0;
+  create(4, prioMark, STACK_TINY);
+  send(tid, nullptr, 0, nullptr, 0);
+  throttled = throttled && !prioSpinnerSawProbe;
+
+  println(COM2, "%s %s setpriority %d %d %d", opt, cch, ready, blocked,
+          throttled);
+}
+
+void startGateway() {
+  create(1, remote::gateway, remote::Config{COM1, 1}, STACK_SMALL);
+}
+
+/**
+ * @brief with the gateway up, send to -1, to remoteTid(-1) and to the result
+ * of a failed whoIs(), and report each return value, which must be -1 as
+ * without a gateway instead of the send going to the peer
+ */
+void remoteBadTid() {
+  startGateway();
+  int rply;
+  int local = send(-1, 0, rply);
+  int remote = send(remoteTid(-1), 0, rply);
+  int missing = send(whoIs("NO_SUCH_TASK"), 0, rply);
+  println(COM2, "%s %s remote badtid %d %d %d", opt, cch, local, remote,
+          missing);
+}
+
+/**
+ * @brief peer side of remoteTest(): echo every message until one starting
+ * with a negative int
+ */
+void remoteEcho() {
+  startGateway();
+  registerAs(REMOTE_ECHO_NAME);
+  char msg[REMOTE_MAX_MSG];
+  int senderTid;
+  while (true) {
+    int len = receive(&senderTid, msg, sizeof(msg));
+    reply(senderTid, msg, len);
+    if (len >= (int)sizeof(int) && *(int *)msg < 0) {
+      break;
+    }
+  }
+  // let the gateway send the last reply before the caller shuts down
+  sleepFor(10);
+}
+
+/**
+ * @brief remote SRR with remoteEcho() on the kernel at the other end of COM1:
+ * round trips of 4-byte messages (min/avg/max in microseconds), then
+ * the throughput of REMOTE_MAX_MSG-byte round trips in bytes per second each
+ * way
+ */
+void remoteTest() {
+  startGateway();
+  int echoTid;
+  while ((echoTid = remoteWhoIs(REMOTE_ECHO_NAME)) < 0) {
+    sleepFor(1);
+  }
+
+  LatencyStats srr;
+  for (int i = 0; i < REMOTE_SAMPLES; ++i) {
+    int rply;
+    unsigned int t0 = timestamp();
+    send(echoTid, i, rply);
+    srr.add(timestamp() - t0);
+  }
+
+  char buf[REMOTE_MAX_MSG];
+  for (int i = 0; i < REMOTE_MAX_MSG; ++i) {
+    buf[i] = 'A' + i % 26;
+  }
+  unsigned int t0 = timestamp();
+  for (int i = 0; i < REMOTE_BULK; ++i) {
+    send(echoTid, buf, sizeof(buf), buf, sizeof(buf));
+  }
+  unsigned int ms = (timestamp() - t0) / (TIMER3_FRQ / 1000);
+  unsigned int bytesPerSec =
+      REMOTE_BULK * REMOTE_MAX_MSG * 1000 / (ms ? ms : 1);
+
+  int stop = -1, rply;
+  send(echoTid, stop, rply);
+
+  // link round trips are long enough to overflow the sum of squares
+  println(COM2, "%s %s remote %u %u %u", opt, cch, srr.min,
+          srr.total / srr.count, srr.max);
+  println(COM2, "%s %s remote bulk %d %u", opt, cch, REMOTE_MAX_MSG,
+          bytesPerSec);
+}
+
+/**
+ * @brief one result of benchmarkSuite(), as
+ * BENCH <opt> <cache> <lock> <name> <value> <unit>
+ */
+void benchReport(const char *name, unsigned int value, const char *unit) {
+  println(COM2, "BENCH %s %s %s %s %u %s", opt, cch, lck, name, value, unit);
+}
+
+void benchEcho() {
+  char msg[BENCH_MAX_MSG];
+  int senderTid;
+  int len;
+  do {
+    len = receive(&senderTid, msg, sizeof(msg));
+    reply(senderTid, msg, len);
+  } while (len > 0);
+}
+
+unsigned int benchWakeTotal, benchWakeMax;
+
+void benchWaiter() {
+  benchWakeTotal = benchWakeMax = 0;
+  for (int i = 0; i < BENCH_WAKE_SAMPLES; ++i) {
+    awaitEvent(IRQ_TC3UI);
+    unsigned int latency = sinceTick();
+    benchWakeTotal += latency;
+    benchWakeMax = latency > benchWakeMax ? latency : benchWakeMax;
+  }
+}
+
+/**
+ * @brief time the kernel primitives one by one and print one BENCH line for
+ * each, for script/bench_table.py to compare across builds
+ *
+ * Syscall round trips and SRR are in ns per call, averaged over 1000 calls;
+ * wake-up latencies are in us after the tick interrupt. Must be called from a
+ * task with a priority lower than 0.
+ */
+void benchmarkSuite() {
+  unsigned int t0 = timestamp();
+  for (int i = 0; i < BENCH_ITERATIONS; ++i) {
+    myTid();
+  }
+  benchReport("my_tid", nsPerRun(timestamp() - t0, BENCH_ITERATIONS), "ns");
+
+  t0 = timestamp();
+  for (int i = 0; i < BENCH_ITERATIONS; ++i) {
+    myParentTid();
+  }
+  benchReport("my_parent_tid", nsPerRun(timestamp() - t0, BENCH_ITERATIONS),
+              "ns");
+
+  // nothing else is ready at our priority, so this is the bare round trip
+  t0 = timestamp();
+  for (int i = 0; i < BENCH_ITERATIONS; ++i) {
+    yield();
+  }
+  benchReport("yield", nsPerRun(timestamp() - t0, BENCH_ITERATIONS), "ns");
+
+  // the child has a higher priority, so it runs and exits before create()
+  // returns
+  t0 = timestamp();
+  for (int i = 0; i < BENCH_ITERATIONS; ++i) {
+    create(0, shortLived, STACK_TINY);
+  }
+  benchReport("create_exit", nsPerRun(timestamp() - t0, BENCH_ITERATIONS),
+              "ns");
+
+  SpawnArgs args{{1, 2, 3, 4, 5}};
+  t0 = timestamp();
+  for (int i = 0; i < BENCH_ITERATIONS; ++i) {
+    create(0, spawnWithArgs, args, STACK_TINY);
+  }
+  benchReport("create_args_exit",
+              nsPerRun(timestamp() - t0, BENCH_ITERATIONS), "ns");
+
+  // receiver first, as the echo server has a higher priority
+  int echoTid = create(0, benchEcho, STACK_TINY);
+  char msg[BENCH_MAX_MSG];
+  for (int i = 0; i < BENCH_MAX_MSG; ++i) {
+    msg[i] = 'A';
+  }
+  const int sizes[] = {4, 64, 256};
+  const char *const srrNames[] = {"srr_4", "srr_64", "srr_256"};
+  for (int i = 0; i < 3; ++i) {
+    t0 = timestamp();
+    for (int j = 0; j < BENCH_ITERATIONS; ++j) {
+      send(echoTid, msg, sizes[i], msg, sizes[i]);
+    }
+    benchReport(srrNames[i], nsPerRun(timestamp() - t0, BENCH_ITERATIONS),
+                "ns");
+  }
+  send(echoTid, nullptr, 0, nullptr, 0);
+
+  t0 = timestamp();
+  for (int i = 0; i < BENCH_ITERATIONS; ++i) {
+    whoIs(CLOCK_SERVER_NAME);
+  }
+  benchReport("who_is", nsPerRun(timestamp() - t0, BENCH_ITERATIONS), "ns");
+
+  create(0, benchWaiter, STACK_TINY);
+  sleepFor(BENCH_WAKE_SAMPLES + 2);
+  benchReport("await_event_avg",
+              benchWakeTotal / BENCH_WAKE_SAMPLES * 1000 / (TIMER3_FRQ / 1000),
+              "us");
+  benchReport("await_event_max", benchWakeMax * 1000 / (TIMER3_FRQ / 1000),
+              "us");
+
+  unsigned int minDelay = -1, maxDelay = 0, totalDelay = 0;
+  for (int i = 0; i < BENCH_WAKE_SAMPLES; ++i) {
+    clock::delay(1);
+    unsigned int latency = sinceTick();
+    minDelay = latency < minDelay ? latency : minDelay;
+    maxDelay = latency > maxDelay ? latency : maxDelay;
+    totalDelay += latency;
+  }
+  benchReport("delay_avg",
+              totalDelay / BENCH_WAKE_SAMPLES * 1000 / (TIMER3_FRQ / 1000),
+              "us");
+  benchReport("delay_jitter",
+              (maxDelay - minDelay) * 1000 / (TIMER3_FRQ / 1000), "us");
+
+  // how late a sub-tick sleep wakes; rounded up to the tick when periodic
+  unsigned int totalLate = 0;
+  for (int i = 0; i < BENCH_WAKE_SAMPLES; ++i) {
+    t0 = timestamp();
+    clock::delayUs(BENCH_DELAY_US);
+    totalLate += (timestamp() - t0) * 1000 / (TIMER3_FRQ / 1000) - BENCH_DELAY_US;
+  }
+  benchReport("delay_us_late", totalLate / BENCH_WAKE_SAMPLES, "us");
+
+  // one character per call, overwriting a single line of the terminal; timed
+  // until the last byte has left the UART, as in uartThroughput()
+  uartFlush(COM2);
+  t0 = timestamp();
+  for (int i = 0; i < BENCH_PUTC_BYTES; ++i) {
+    putc(COM2, i % SCREEN_COLS == SCREEN_COLS - 1 ? '\r' : '.');
+  }
+  uartFlush(COM2);
+  unsigned int us = countsToUs(timestamp() - t0);
+  putstr(COM2, "\033[2K\r");
+  benchReport("putc",
+              (unsigned int)(BENCH_PUTC_BYTES * 1000000ULL / (us ? us : 1)),
+              "B/s");
+}
+
 void senderFirst() {
   timerTest();
   create(2, sender);
@@ -97,4 +1124,48 @@ void receiverFirst() {
   create(2, receiver);
 }
 
+struct NamedTest {
+  const char *name;
+  void (*run)();
+};
+
+const NamedTest namedTests[] = {
+    {"yield", yieldTest},
+    {"churn", churnTest},
+    {"create", createTest},
+    {"sleep", sleepLatency},
+    {"sleepers", maxSleepers},
+    {"latency", latencyTest},
+    {"edf", edfTest},
+    {"remote", remoteTest},
+    {"remoteecho", remoteEcho},
+    {"remotebadtid", remoteBadTid},
+    {"bench", benchmarkSuite},
+    {"periodic", periodicTest},
+    {"timers", timerHandleTest},
+    {"setpriority", setPriorityTest},
+    {"uart", uartThroughput},
+    {"routing", routingTest},
+    {"routingpar", routingParallelTest},
+};
+
+void runNamed(int count, char *const names[]) {
+  create(0, nameServer, STACK_SMALL);
+  create(0, clockServer, STACK_SMALL);
+  create(7, idleTask, STACK_TINY);
+  for (int i = 0; i < count; ++i) {
+    bool found = false;
+    for (const NamedTest &test : namedTests) {
+      if (String{test.name} == String{names[i]}) {
+        test.run();
+        found = true;
+      }
+    }
+    if (!found) {
+      println(COM2, "unknown test: %s", names[i]);
+    }
+  }
+  shutdown();
+}
+
 }  // namespace perf_test
\ No newline at end of file
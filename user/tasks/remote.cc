@@ -0,0 +1,265 @@
+#include "remote.h"
+
+#include "lib/queue.h"
+#include "user/message.h"
+#include "user/task.h"
+#include "user/uart.h"
+
+// A frame on the link is
+//   FRAME_SYNC, type, len, body[len], checksum (2 bytes, Fletcher-16 of type,
+//   len and body)
+// with the body holding two 4-byte little-endian ints followed by the data:
+//   FRAME_SEND:  sender tid, receiver tid on the peer, message
+//   FRAME_REPLY: tid of the original sender, result of the send, reply
+#define FRAME_SYNC 0x7e
+#define FRAME_SEND 1
+#define FRAME_REPLY 2
+#define FRAME_HEADER_LEN 8
+#define FRAME_BODY_MAX (FRAME_HEADER_LEN + REMOTE_MAX_MSG)
+#define FRAME_MAX (FRAME_BODY_MAX + 5)
+
+// incoming sends waiting for a free worker
+#define PENDING_CAP 16
+
+namespace remote {
+
+namespace {
+
+struct Frame {
+  int type;
+  int src;
+  int arg;  // receiver tid for FRAME_SEND, result of the send for FRAME_REPLY
+  int len;  // of data
+  char data[REMOTE_MAX_MSG];
+};
+
+struct Msg {
+  enum class Action {
+    Frame,        // frame = a frame read from the link
+    WorkerReady,  // frame = reply of the last job, type 0 on the first send
+  };
+  Action action;
+  Frame frame;
+};
+
+class Checksum {
+  unsigned int sum1, sum2;
+
+ public:
+  Checksum() : sum1{0}, sum2{0} {}
+
+  void add(unsigned char byte) {
+    sum1 = (sum1 + byte) % 255;
+    sum2 = (sum2 + sum1) % 255;
+  }
+
+  unsigned int value() const { return sum2 << 8 | sum1; }
+};
+
+void putInt(unsigned char *buf, int val) {
+  for (int i = 0; i < 4; ++i) {
+    buf[i] = (unsigned int)val >> (i * 8);
+  }
+}
+
+int getInt(const unsigned char *buf) {
+  unsigned int val = 0;
+  for (int i = 0; i < 4; ++i) {
+    val |= (unsigned int)buf[i] << (i * 8);
+  }
+  return val;
+}
+
+void writeFrame(unsigned int channel, const Frame &frame) {
+  unsigned char buf[FRAME_MAX];
+  int bodyLen = FRAME_HEADER_LEN + frame.len;
+  buf[0] = FRAME_SYNC;
+  buf[1] = frame.type;
+  buf[2] = bodyLen;
+  putInt(buf + 3, frame.src);
+  putInt(buf + 7, frame.arg);
+  for (int i = 0; i < frame.len; ++i) {
+    buf[3 + FRAME_HEADER_LEN + i] = frame.data[i];
+  }
+  Checksum sum;
+  for (int i = 1; i < 3 + bodyLen; ++i) {
+    sum.add(buf[i]);
+  }
+  buf[3 + bodyLen] = sum.value() >> 8;
+  buf[4 + bodyLen] = sum.value();
+  // a single write, so frames from one task are never interleaved
+  uartWrite(channel, (const char *)buf, 5 + bodyLen);
+}
+
+/**
+ * Reassembles frames from the bytes read off the link. A frame with a bad
+ * length or checksum is dropped and the reader looks for the next FRAME_SYNC.
+ */
+class FrameReader {
+  enum class State { Sync, Type, Len, Body, SumHigh, SumLow };
+  State state;
+  int type, len, received;
+  unsigned char body[FRAME_BODY_MAX];
+  Checksum sum;
+  unsigned int sumHigh;
+
+ public:
+  FrameReader() : state{State::Sync}, type{0}, len{0}, received{0} {}
+
+  /**
+   * @return whether byte completed a valid frame, which is then stored in
+   * frame
+   */
+  bool feed(unsigned char byte, Frame &frame) {
+    switch (state) {
+      case State::Sync:
+        if (byte == FRAME_SYNC) {
+          sum = Checksum{};
+          state = State::Type;
+        }
+        return false;
+      case State::Type:
+        type = byte;
+        sum.add(byte);
+        state = type == FRAME_SEND || type == FRAME_REPLY ? State::Len
+                                                          : State::Sync;
+        return false;
+      case State::Len:
+        len = byte;
+        sum.add(byte);
+        received = 0;
+        state = len >= FRAME_HEADER_LEN && len <= FRAME_BODY_MAX ? State::Body
+                                                                 : State::Sync;
+        return false;
+      case State::Body:
+        body[received++] = byte;
+        sum.add(byte);
+        if (received == len) {
+          state = State::SumHigh;
+        }
+        return false;
+      case State::SumHigh:
+        sumHigh = byte;
+        state = State::SumLow;
+        return false;
+      case State::SumLow:
+        state = State::Sync;
+        if ((sumHigh << 8 | byte) != sum.value()) {
+          return false;
+        }
+        frame.type = type;
+        frame.src = getInt(body);
+        frame.arg = getInt(body + 4);
+        frame.len = len - FRAME_HEADER_LEN;
+        for (int i = 0; i < frame.len; ++i) {
+          frame.data[i] = body[FRAME_HEADER_LEN + i];
+        }
+        return true;
+    }
+    return false;
+  }
+};
+
+void linkReader(const Config *config) {
+  unsigned int channel = config->channel;
+  int gatewayTid = myParentTid();
+  FrameReader reader;
+  Msg msg;
+  msg.action = Msg::Action::Frame;
+  char buf[64];
+  while (true) {
+    int len = uartRead(channel, buf, sizeof(buf));
+    for (int i = 0; i < len; ++i) {
+      if (reader.feed(buf[i], msg.frame)) {
+        send(gatewayTid, msg);
+      }
+    }
+  }
+}
+
+/**
+ * @brief delivers sends from the peer to local tasks, one at a time, so that
+ * the gateway never blocks on a local receiver
+ */
+void worker() {
+  int gatewayTid = myParentTid();
+  Msg msg;
+  msg.action = Msg::Action::WorkerReady;
+  msg.frame.type = 0;
+  Frame job;
+  while (true) {
+    send(gatewayTid, msg, job);
+    int ret = send(job.arg & ~REMOTE_TID_FLAG, job.data, job.len,
+                   msg.frame.data, REMOTE_MAX_MSG);
+    msg.frame.type = FRAME_REPLY;
+    msg.frame.src = job.src;
+    msg.frame.arg = ret;
+    msg.frame.len = ret > 0 ? ret : 0;
+  }
+}
+
+}  // namespace
+
+void gateway(const Config *config) {
+  Config cfg = *config;
+  setGateway();
+  create(cfg.priority, linkReader, cfg, STACK_TINY);
+  for (int i = 0; i < REMOTE_WORKERS; ++i) {
+    create(cfg.priority, worker, STACK_TINY);
+  }
+
+  Queue<int, REMOTE_WORKERS> idleWorkers;
+  Queue<Frame, PENDING_CAP> pending;
+  union {
+    Msg msg;
+    char data[REMOTE_MAX_MSG];
+  } buf;
+  int senderTid;
+
+  while (true) {
+    int len = receive(&senderTid, &buf, sizeof(buf));
+
+    int target = remoteTarget(senderTid);
+    if (target >= 0) {
+      // a local task sending to the peer; it stays reply-blocked on us until
+      // the reply frame comes back
+      Frame frame{FRAME_SEND, senderTid, target,
+                  len < REMOTE_MAX_MSG ? len : REMOTE_MAX_MSG, {}};
+      for (int i = 0; i < frame.len; ++i) {
+        frame.data[i] = buf.data[i];
+      }
+      writeFrame(cfg.channel, frame);
+      continue;
+    }
+
+    Msg &msg = buf.msg;
+    switch (msg.action) {
+      case Msg::Action::Frame: {
+        reply(senderTid);
+        const Frame &frame = msg.frame;
+        if (frame.type == FRAME_REPLY) {
+          reply(frame.src, frame.data, frame.len);
+        } else if (idleWorkers.size() > 0) {
+          reply(idleWorkers.dequeue(), frame);
+        } else if (!pending.enqueue(frame)) {
+          Frame busy{FRAME_REPLY, frame.src, -1, 0, {}};
+          writeFrame(cfg.channel, busy);
+        }
+        break;
+      }
+      case Msg::Action::WorkerReady: {
+        if (msg.frame.type == FRAME_REPLY) {
+          writeFrame(cfg.channel, msg.frame);
+        }
+        if (pending.size() > 0) {
+          reply(senderTid, pending.dequeue());
+        } else {
+          idleWorkers.enqueue(senderTid);
+        }
+        break;
+      }
+    }
+  }
+}
+
+}  // namespace remote
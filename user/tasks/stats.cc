@@ -2,18 +2,25 @@
 #include "display_server.h"
 #include "kern/sys.h"
 #include "name_server.h"
+#include "user/task.h"
 #include "user/message.h"
+#include "user/sleep.h"
 
 void stats() {
   int displayServerTid = whoIs(DISPLAY_SERVER_NAME);
-  int clockServerTid = whoIs(CLOCK_SERVER_NAME);
-  int t = 0;
+  unsigned int lastTimeQueries = 0;
 
+  setPeriod(10, 10);
   while (true) {
     unsigned int idleTime = getIdleTime();
-    unsigned int sysTime = time(clockServerTid);
-    view::Msg msg{view::Action::Time, {sysTime, idleTime}};
+    unsigned int sysTime = clock::time();
+    // every query used to be an SRR to the clock server
+    int timeQueries = (clock::timeQueries - lastTimeQueries) * 10;
+    lastTimeQueries = clock::timeQueries;
+    int stackKb = stackInUse() / 1024;
+    view::Msg msg{view::Action::Time,
+                  {(int)sysTime, (int)idleTime, timeQueries, stackKb}};
     send(displayServerTid, msg);
-    clock::delayUntil(t += 10);
+    waitNextPeriod();
   }
 }
\ No newline at end of file